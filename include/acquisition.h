@@ -0,0 +1,102 @@
+/*
+Acquisition des capteurs en arrière-plan
+
+Chaque capteur est interrogé par sa propre tâche (voir ordonnanceur.h)
+et les valeurs converties sont conservées dans une copie en cache
+(struct Mesures). La température et l'humidité du BME280 et du SCD41
+sont fusionnées à l'arrivée de chaque échantillon (voir fusion.h) : une
+requête ne lit qu'une valeur fusionnée. Les tâches ignorent les capteurs
+indisponibles (voir capteurs.h). Les lectures passent par la file I2C
+(voir bus_i2c.h), vidée par une tâche qui n'exécute qu'une transaction
+à la fois.
+Le gestionnaire CAN ne fait que sérialiser cette copie : aucune
+transaction I2C n'est effectuée pendant la réponse à une requête 0x1A4.
+*/
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdint.h>
+#include <Wire.h>
+#include "SparkFunBME280.h"
+#include "bme280_profils.h"
+#include "donnees.h"
+#include "ordonnanceur.h"
+
+// Adresse I2C par défaut du BME280 (modifiable par la configuration)
+#define BME280_ADRESSE 0x77
+
+// La période d'interrogation de l'ADS7828 découle de table_donnees (voir
+// donnees.h), celle du BME280 de son profil (voir bme280_profils.h) ; le
+// SCD41 avance sa machine à états à son propre rythme
+#define PERIODE_SCD41_ETAPE_MS 2 // une étape de la machine à états (voir scd41.h)
+
+// Retards tolérés avant de compter une échéance manquée (ms)
+#define DELAI_GAZ_MS 2    // gigue d'échantillonnage des gaz
+#define DELAI_I2C_MS 5    // attente d'une transaction dans la file
+#define DELAI_SCD41_MS 10 // la mesure du SCD41 reste prête ~5 s
+#define DELAI_BME280_MS 50
+
+// Le décalage du SCD41 n'est appris que si le BME280 a mesuré depuis moins de (ms)
+#define FUSION_REFERENCE_MS (4 * PERIODE_BME280_MS)
+
+// Tâches d'acquisition, par ordre de priorité décroissante
+enum TacheAcquisition
+{
+    TACHE_GAZ,    // soumet les conversions des gaz (échantillonnage rapide)
+    TACHE_I2C,    // exécute une transaction de la file I2C
+    TACHE_SCD41,  // une étape de la machine à états du SCD41
+    TACHE_BME280, // soumet la rafale de lecture du BME280
+    NB_TACHES_ACQUISITION
+};
+
+// Échantillons de la moyenne glissante des gaz (16 = 4^2 : 2 bits de plus, fenêtre de 160 ms)
+#define ECHANTILLONS_GAZ 16
+
+// Capteurs partagés (définis dans main.cpp)
+extern TwoWire myWire;
+extern BME280 BME280_Sensor;
+
+/*
+ * Fonction : acquisition_tache
+ * But : Donne accès à une tâche d'acquisition pour l'ordonnanceur
+ */
+Tache &acquisition_tache(TacheAcquisition tache);
+
+/*
+ * Fonction : acquisition_mesures
+ * But : Donne accès à la dernière copie des mesures
+ */
+const Mesures &acquisition_mesures();
+
+/*
+ * Fonction : acquisition_horodatage
+ * But : Instant (millis()) de la dernière mise à jour d'une donnée
+ */
+uint32_t acquisition_horodatage(Donnee donnee);
+
+/*
+ * Fonction : acquisition_rafraichir
+ * But : Avance la prochaine lecture du capteur qui fournit une donnée
+ *       (sans effet sur le SCD41, qui mesure à son propre rythme)
+ * Paramètres :
+ *    - donnee : donnée jugée trop ancienne
+ *    - maintenant : temps courant en ms (millis())
+ */
+void acquisition_rafraichir(Donnee donnee, uint32_t maintenant);
+
+/*
+ * Fonction : acquisition_choisir_profil_bme280
+ * But : Change le profil du BME280, la période de sa tâche et la fenêtre
+ *       de fraîcheur minimale des données qu'il fournit (température,
+ *       humidité, pression) ; les registres sont écrits avant la prochaine
+ *       lecture
+ * Paramètres :
+ *    - profil : profil à appliquer (ignoré s'il n'existe pas)
+ */
+void acquisition_choisir_profil_bme280(ProfilBme280 profil);
+
+// Profil courant du BME280 (PROFIL_BME280_DEFAUT au démarrage)
+ProfilBme280 acquisition_profil_bme280();
+
+#endif
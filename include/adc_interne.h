@@ -0,0 +1,58 @@
+/*
+ADC interne du STM32F446 pour les capteurs de gaz (option GAZ_ADC_INTERNE)
+
+Remplace l'ADS7828 lorsque le firmware est compilé avec -DGAZ_ADC_INTERNE
+(env:nucleo_f446re_adc_interne). L'ADC1 convertit les deux canaux en
+continu (mode scan) et le DMA2 (flux 0, canal 0) les range dans un tampon
+circulaire : l'échantillonnage ne coûte aucun cycle au processeur et ne
+passe plus par le bus I2C, laissé au BME280 et au SCD41.
+
+Avec ADCCLK = PCLK2 / 4 (22,5 MHz) et 480 cycles d'échantillonnage, chaque
+canal est converti à environ 23 kHz. adc_interne_soumettre() garde
+l'interface de ads7828_soumettre() : elle moyenne les ADC_INTERNE_TOURS
+dernières conversions du canal et appelle aussitôt la fonction de fin.
+
+Les entrées ne doivent pas dépasser VDDA (3,3 V) : les sorties des capteurs
+alimentés en 5 V passent par un pont diviseur (10 kΩ en série, 18 kΩ vers
+la masse, 5 V ramenés à 3,2 V). La conversion en ppm multiplie la tension
+lue par ADC_INTERNE_PONT_DIVISEUR pour retrouver celle du capteur.
+*/
+
+#ifndef ADC_INTERNE_H
+#define ADC_INTERNE_H
+
+#include <stdint.h>
+
+// Canaux de l'ADC1 des capteurs analogiques (broches A0 et A1 de la Nucleo)
+#define ADC_INTERNE_CANAL_MQ7 0     // PA0 : capteur de CO
+#define ADC_INTERNE_CANAL_SEN_094 1 // PA1 : capteur de méthane
+
+// Rapport du pont diviseur : tension du capteur / tension de la broche
+#define ADC_INTERNE_PONT_HAUT_KOHM 10.0f
+#define ADC_INTERNE_PONT_BAS_KOHM 18.0f
+#define ADC_INTERNE_PONT_DIVISEUR ((ADC_INTERNE_PONT_HAUT_KOHM + ADC_INTERNE_PONT_BAS_KOHM) / ADC_INTERNE_PONT_BAS_KOHM)
+
+// Conversions de chaque canal conservées dans le tampon circulaire
+#define ADC_INTERNE_TOURS 32
+
+/*
+ * Fonction : adc_interne_init
+ * But : Configure l'ADC1 et le DMA, puis lance les conversions continues
+ * Retour :
+ *    - false si l'ADC n'a pas démarré
+ */
+bool adc_interne_init();
+
+/*
+ * Fonction : adc_interne_soumettre
+ * But : Lit la moyenne des dernières conversions d'un canal dans le tampon DMA
+ * Paramètres :
+ *    - canal : ADC_INTERNE_CANAL_MQ7 ou ADC_INTERNE_CANAL_SEN_094
+ *    - fin : fonction appelée immédiatement avec le code 12 bits
+ *    - contexte : valeur retransmise à la fonction fin
+ * Retour :
+ *    - false si le canal est inconnu ou si le DMA s'est arrêté sur une erreur
+ */
+bool adc_interne_soumettre(uint8_t canal, void (*fin)(uint16_t code, uint32_t contexte), uint32_t contexte);
+
+#endif
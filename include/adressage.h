@@ -0,0 +1,77 @@
+/*
+Adressage des cartes partageant un même bus CAN
+
+Le numéro du nœud est lu au démarrage sur deux broches de configuration
+(cavalier vers la masse = bit à 1), ce qui permet d'installer jusqu'à
+CAN_NB_NOEUDS cartes avec le même programme. Chaque nœud utilise le bloc
+d'identifiants base + 0x10 * numéro (voir protocole.h), où la base vaut
+CAN_ID_BASE tant que la configuration ne la change pas (voir configuration.h).
+
+Requête « échantillonner tout » (ID base - 1, 0x19F par défaut) :
+    Même masque que la requête 0x1A4. Chaque nœud répond sur ses propres
+    identifiants, décalé de numéro * ADRESSAGE_CRENEAU_US, pour que les
+    réponses ne se disputent pas l'arbitrage du bus.
+*/
+
+#ifndef ADRESSAGE_H
+#define ADRESSAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "protocole.h"
+
+// Broches de configuration du numéro de nœud (entrées avec pull-up)
+#define ADRESSAGE_BROCHE_BIT0 PC0
+#define ADRESSAGE_BROCHE_BIT1 PC1
+
+// Durée d'un créneau de réponse : deux trames de 8 octets prennent ~0,5 ms
+// à 500 kbps, la marge couvre le délai de traitement de loop()
+#define ADRESSAGE_CRENEAU_US 2000
+
+/*
+ * Fonction : adressage_init
+ * But : Lit le numéro du nœud sur les broches de configuration
+ * Paramètres :
+ *    - base : identifiant du bloc du nœud 0 (alignée sur CAN_TAILLE_BLOC)
+ */
+void adressage_init(uint16_t base);
+
+// Numéro du nœud (0 à CAN_NB_NOEUDS - 1)
+uint8_t adressage_noeud();
+
+// Premier identifiant du bloc du nœud
+uint32_t adressage_base();
+
+// Identifiant de la requête « échantillonner tout », commun à tous les nœuds
+uint32_t adressage_groupe();
+
+// Identifiant du nœud à une position du bloc (CAN_DECALAGE_...)
+inline uint32_t adressage_id(uint8_t decalage)
+{
+    return adressage_base() + decalage;
+}
+
+/*
+ * Fonction : adressage_requete_groupe
+ * But : Planifie la réponse à une requête « échantillonner tout » dans le
+ *       créneau du nœud (une nouvelle requête remplace celle en attente)
+ * Paramètres :
+ *    - masque : un octet 0x11 par donnée désirée
+ *    - longueur : nombre d'octets du masque
+ *    - maintenant_us : temps courant en µs (micros())
+ */
+void adressage_requete_groupe(const uint8_t *masque, size_t longueur, uint32_t maintenant_us);
+
+/*
+ * Fonction : adressage_creneau
+ * But : Indique si le créneau de la réponse en attente est atteint
+ * Paramètres :
+ *    - maintenant_us : temps courant en µs (micros())
+ *    - masque : reçoit le masque de la requête (NB_DONNEES octets)
+ *    - longueur : reçoit la longueur du masque
+ * Retour :
+ *    - true une seule fois par requête, lorsque la réponse doit être envoyée
+ */
+bool adressage_creneau(uint32_t maintenant_us, uint8_t masque[NB_DONNEES], size_t &longueur);
+
+#endif
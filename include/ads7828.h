@@ -0,0 +1,34 @@
+/*
+Pilote ADS7828 (ADC 12 bits, 8 canaux, I2C)
+
+Chaque conversion est une transaction de la file I2C : écriture de l'octet
+de commande (canal, mode simple, référence interne 2,5 V et ADC actifs),
+puis lecture des deux octets du résultat. Seuls les canaux utilisés sont
+lus, au lieu des quatre canaux du masque 0x0F de la librairie.
+*/
+
+#ifndef ADS7828_H
+#define ADS7828_H
+
+#include <stdint.h>
+
+// Adresse I2C : 0x48 + A1/A0 (A1 = A0 = 1 sur la carte)
+#define ADS7828_ADRESSE (0x48 | 3)
+
+// Canaux des capteurs analogiques
+#define ADS7828_CANAL_MQ7 0     // Capteur de CO
+#define ADS7828_CANAL_SEN_094 1 // Capteur de méthane
+
+/*
+ * Fonction : ads7828_soumettre
+ * But : Soumet la conversion d'un canal à la file I2C
+ * Paramètres :
+ *    - canal : canal de l'ADC (0 à 7)
+ *    - fin : fonction appelée avec le code 12 bits lorsque la conversion réussit
+ *    - contexte : valeur retransmise à la fonction fin
+ * Retour :
+ *    - false si la file I2C est pleine
+ */
+bool ads7828_soumettre(uint8_t canal, void (*fin)(uint16_t code, uint32_t contexte), uint32_t contexte);
+
+#endif
@@ -0,0 +1,86 @@
+/*
+Alarmes de seuil poussées par le nœud
+
+Chaque donnée peut avoir un seuil haut et une hystérésis, réglés par les
+commandes 0x05/0x06 (voir commandes.h). Le seuil est vérifié à chaque
+nouvelle valeur, dans la chaîne d'acquisition. Une alarme s'active quand
+la valeur atteint le seuil et se désactive quand elle redescend sous
+seuil - hystérésis ; chaque changement est envoyé aussitôt, sans requête
+du maître, sur un identifiant bas (donc prioritaire sur le bus) :
+
+    ID CAN_ID_ALARME_BASE + numéro du nœud (0x0A0 pour le nœud 0)
+    Octet #0 : donnée (0 à 5, ordre du masque)
+    Octet #1 : 1 alarme active, 0 retour sous le seuil
+    Octets #2-#3 : valeur (entier signé, unité de la donnée, LSB en premier)
+    Octets #4-#5 : seuil (même format)
+    Octet #6 : alarmes actives (bit i : donnée i)
+    Octet #7 : compteur de séquence des trames d'alarme
+
+Les seuils et hystérésis sont des entiers dans l'unité de la donnée (ppm,
+°C, %, kPa). Aucun seuil n'est actif au démarrage.
+*/
+
+#ifndef ALARMES_H
+#define ALARMES_H
+
+#include <stdint.h>
+#include "mesures.h"
+
+// Identifiant des trames d'alarme du nœud 0 (les nœuds suivants prennent les ID suivants)
+#ifndef CAN_ID_ALARME_BASE
+#define CAN_ID_ALARME_BASE 0x0A0
+#endif
+
+// Taille de la trame d'alarme
+#define ALARMES_TAILLE_TRAME 8
+
+/*
+ * Fonction : alarmes_configurer
+ * But : Active ou désactive le seuil d'une donnée
+ * Paramètres :
+ *    - donnee : donnée surveillée
+ *    - seuil : valeur qui déclenche l'alarme
+ *    - hysteresis : écart sous le seuil pour revenir à l'état normal
+ *    - active : false pour désactiver le seuil (l'alarme en cours est levée)
+ * Retour :
+ *    - false si la donnée n'existe pas
+ */
+bool alarmes_configurer(uint8_t donnee, int16_t seuil, uint16_t hysteresis, bool active);
+
+/*
+ * Fonction : alarmes_configuration
+ * But : Lit le réglage d'une donnée
+ * Retour :
+ *    - false si la donnée n'existe pas
+ */
+bool alarmes_configuration(uint8_t donnee, int16_t &seuil, uint16_t &hysteresis, bool &active);
+
+/*
+ * Fonction : alarmes_evaluer
+ * But : Compare une nouvelle valeur à son seuil et retient les changements d'état
+ */
+void alarmes_evaluer(Donnee donnee, float valeur);
+
+// Indique si un changement d'état attend d'être envoyé
+bool alarmes_en_attente();
+
+/*
+ * Fonction : alarmes_trame
+ * But : Prépare la trame du premier changement d'état en attente, dans
+ *       l'ordre des données, sans le retirer de l'attente
+ * Paramètres :
+ *    - donnees : tableau de ALARMES_TAILLE_TRAME octets
+ * Retour :
+ *    - false si aucun changement n'est en attente
+ */
+bool alarmes_trame(uint8_t donnees[8]);
+
+/*
+ * Fonction : alarmes_envoyee
+ * But : Retire de l'attente le changement dont la trame a été acceptée par la file d'émission
+ * Paramètres :
+ *    - donnee : octet #0 de la trame envoyée
+ */
+void alarmes_envoyee(uint8_t donnee);
+
+#endif
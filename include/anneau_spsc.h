@@ -0,0 +1,81 @@
+/*
+Tampon circulaire sans verrou à un producteur et un consommateur (SPSC)
+
+Le producteur (typiquement une interruption) appelle uniquement pousser(),
+le consommateur (la boucle principale) appelle uniquement retirer().
+Aucune section critique n'est nécessaire : chaque index n'est écrit que
+par un seul des deux côtés.
+*/
+
+#ifndef ANNEAU_SPSC_H
+#define ANNEAU_SPSC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, size_t N>
+class AnneauSpsc
+{
+    static_assert(N != 0 && (N & (N - 1)) == 0, "N doit etre une puissance de 2");
+
+public:
+    /*
+     * Fonction : pousser
+     * But : Ajoute un élément (côté producteur uniquement)
+     * Retour :
+     *    - false si le tampon est plein ; l'élément est perdu et le compteur
+     *      de débordements est incrémenté
+     */
+    bool pousser(const T &element)
+    {
+        uint32_t t = tete.load(std::memory_order_relaxed);
+        if (t - queue.load(std::memory_order_acquire) >= N)
+        {
+            nb_debordements.store(nb_debordements.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+            return false;
+        }
+        elements[t & (N - 1)] = element;
+        tete.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * Fonction : retirer
+     * But : Retire l'élément le plus ancien (côté consommateur uniquement)
+     * Retour :
+     *    - false si le tampon est vide
+     */
+    bool retirer(T &element)
+    {
+        uint32_t q = queue.load(std::memory_order_relaxed);
+        if (q == tete.load(std::memory_order_acquire))
+            return false;
+        element = elements[q & (N - 1)];
+        queue.store(q + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Nombre d'éléments en attente
+    size_t taille() const
+    {
+        return tete.load(std::memory_order_acquire) - queue.load(std::memory_order_acquire);
+    }
+
+    // Nombre d'éléments perdus parce que le tampon était plein
+    uint32_t debordements() const
+    {
+        return nb_debordements.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacite() { return N; }
+
+private:
+    T elements[N];
+    std::atomic<uint32_t> tete{0};  // écrit par le producteur
+    std::atomic<uint32_t> queue{0}; // écrit par le consommateur
+    std::atomic<uint32_t> nb_debordements{0};
+};
+
+#endif
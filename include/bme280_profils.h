@@ -0,0 +1,118 @@
+/*
+Profils de mesure du BME280
+
+Le BME280 tourne en mode normal : il enchaîne seul les conversions,
+séparées par un temps de veille, et la tâche d'acquisition lit le dernier
+résultat (voir bme280_rafale.h). Un profil fixe le suréchantillonnage, le
+filtre IIR, la veille et la période de lecture de la tâche, choisie pour
+couvrir une conversion complète et sa veille : lire plus souvent ne
+ferait que relire le même résultat.
+
+    Profil      Suréch. T/P/H  IIR   Veille    Conversion max  Lecture
+    rapide      x1             non   0,5 ms    9,3 ms          10 ms
+    équilibré   x4             4     62,5 ms   30 ms           100 ms
+    précis      x16            16    250 ms    113 ms          500 ms
+
+Le profil rapide suit une variation en une lecture mais garde tout le
+bruit du capteur ; le profil précis réduit le bruit de la pression à
+quelques Pa au prix d'une réponse de plusieurs secondes (filtre IIR).
+Choisir un profil dont la lecture n'est pas plus lente que la période de
+diffusion (voir diffusion.h).
+
+Le profil est un champ de la configuration (voir configuration.h) et se
+change en marche : les registres sont écrits par deux transactions de la
+file I2C, sans bloquer loop().
+*/
+
+#ifndef BME280_PROFILS_H
+#define BME280_PROFILS_H
+
+#include <stdint.h>
+#include "donnees.h"
+
+// Registres de réglage
+#define BME280_REG_CTRL_HUM 0xF2
+#define BME280_REG_CTRL_MEAS 0xF4
+#define BME280_REG_CONFIG 0xF5
+
+// Mode normal dans ctrl_meas (0 : veille, nécessaire pour écrire config)
+#define BME280_MODE_VEILLE 0x00
+#define BME280_MODE_NORMAL 0x03
+
+enum ProfilBme280
+{
+    PROFIL_BME280_RAPIDE,
+    PROFIL_BME280_EQUILIBRE,
+    PROFIL_BME280_PRECIS,
+    NB_PROFILS_BME280
+};
+
+/*
+ * Structure : ReglageBme280
+ * But : Valeurs des registres d'un profil (codes de la fiche technique)
+ */
+struct ReglageBme280
+{
+    uint8_t osrs_t;      // suréchantillonnage de la température : 1 = x1 ... 5 = x16
+    uint8_t osrs_p;      // suréchantillonnage de la pression
+    uint8_t osrs_h;      // suréchantillonnage de l'humidité
+    uint8_t filtre;      // coefficient IIR : 0 = désactivé ... 4 = 16
+    uint8_t veille;      // t_sb : 0 = 0,5 ms, 1 = 62,5 ms, 3 = 250 ms
+    uint32_t veille_us;  // durée correspondant à t_sb
+    uint16_t periode_ms; // période de lecture de la tâche d'acquisition
+};
+
+// Une ligne par profil, dans l'ordre de l'enum ProfilBme280
+constexpr ReglageBme280 profils_bme280[] = {
+    {1, 1, 1, 0, 0, 500, 10},                   // PROFIL_BME280_RAPIDE
+    {3, 3, 3, 2, 1, 62500, 100},                // PROFIL_BME280_EQUILIBRE
+    {5, 5, 5, 4, 3, 250000, PERIODE_BME280_MS}, // PROFIL_BME280_PRECIS
+};
+
+// Profil par défaut : période de lecture de table_donnees
+#define PROFIL_BME280_DEFAUT PROFIL_BME280_PRECIS
+
+static_assert(sizeof(profils_bme280) / sizeof(profils_bme280[0]) == NB_PROFILS_BME280,
+              "profils_bme280 doit avoir une ligne par profil");
+
+// Facteur de suréchantillonnage d'un code osrs (0 : mesure désactivée)
+constexpr uint32_t bme280_facteur(uint8_t osrs)
+{
+    return osrs == 0 ? 0 : (1u << (osrs - 1));
+}
+
+// Durée maximale d'une conversion (fiche technique, annexe 9.1), en µs
+constexpr uint32_t bme280_conversion_us(const ReglageBme280 &r)
+{
+    return 1250 + 2300 * bme280_facteur(r.osrs_t) + (r.osrs_p ? 2300 * bme280_facteur(r.osrs_p) + 575 : 0) +
+           (r.osrs_h ? 2300 * bme280_facteur(r.osrs_h) + 575 : 0);
+}
+
+// Chaque lecture doit trouver une nouvelle conversion terminée
+constexpr bool bme280_profils_valides()
+{
+    for (size_t i = 0; i < NB_PROFILS_BME280; i++)
+    {
+        const ReglageBme280 &r = profils_bme280[i];
+        if (bme280_conversion_us(r) + r.veille_us > r.periode_ms * 1000u || r.periode_ms > PERIODE_BME280_MS)
+            return false;
+    }
+    return true;
+}
+
+static_assert(bme280_profils_valides(),
+              "La periode de lecture d'un profil doit couvrir une conversion et ne pas depasser PERIODE_BME280_MS");
+
+/*
+ * Fonction : bme280_soumettre_profil
+ * But : Soumet à la file I2C l'écriture des registres d'un profil
+ *       (veille, config, ctrl_hum, puis ctrl_meas en mode normal)
+ * Paramètres :
+ *    - adresse : adresse I2C du capteur
+ *    - profil : profil à appliquer
+ * Retour :
+ *    - false si le profil n'existe pas ou si la file I2C est pleine
+ */
+bool bme280_soumettre_profil(uint8_t adresse, ProfilBme280 profil);
+
+#endif
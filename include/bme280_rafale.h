@@ -0,0 +1,58 @@
+/*
+Lecture en rafale du BME280
+
+readTempC(), readFloatHumidity() et readFloatPressure() de la librairie
+SparkFun font chacune leur propre lecture I2C, et l'humidité et la pression
+relisent la température pour obtenir t_fine : une lecture complète lit
+environ 5 fois les registres bruts. Ici, les registres 0xF7 à 0xFE sont lus
+en une seule rafale (une transaction de la file I2C) et la compensation
+Bosch est faite une seule fois pour les trois sorties, avec les
+coefficients déjà chargés par la librairie.
+*/
+
+#ifndef BME280_RAFALE_H
+#define BME280_RAFALE_H
+
+#include <stdint.h>
+#include "SparkFunBME280.h"
+
+// Premier registre de données et nombre d'octets (press[3], temp[3], hum[2])
+#define BME280_REG_DONNEES 0xF7
+#define BME280_TAILLE_DONNEES 8
+
+/*
+ * Structure : Bme280Mesure
+ * But : Résultat compensé d'une lecture en rafale
+ */
+struct Bme280Mesure
+{
+    float temperature_c;
+    float humidite_pct;
+    float pression_pa;
+};
+
+/*
+ * Fonction : bme280_compenser
+ * But : Applique les formules entières de compensation Bosch aux données brutes
+ * Paramètres :
+ *    - calibration : coefficients lus dans le capteur
+ *    - brut : registres 0xF7 à 0xFE
+ *    - mesure : résultat compensé
+ */
+void bme280_compenser(const SensorCalibration &calibration, const uint8_t brut[BME280_TAILLE_DONNEES],
+                      Bme280Mesure &mesure);
+
+/*
+ * Fonction : bme280_soumettre_rafale
+ * But : Soumet la lecture en rafale à la file I2C ; la fonction fin reçoit
+ *       la mesure compensée lorsque la transaction réussit
+ * Paramètres :
+ *    - capteur : BME280 déjà initialisé par beginI2C()
+ *    - adresse : adresse I2C du capteur
+ *    - fin : fonction appelée avec le résultat
+ * Retour :
+ *    - false si la file I2C est pleine
+ */
+bool bme280_soumettre_rafale(BME280 &capteur, uint8_t adresse, void (*fin)(const Bme280Mesure &mesure));
+
+#endif
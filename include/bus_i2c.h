@@ -0,0 +1,132 @@
+/*
+File de transactions I2C
+
+Les pilotes des capteurs soumettent leurs transactions (écriture puis
+lecture optionnelle) dans une file et sont prévenus par une fonction de
+rappel à la fin de chacune. Le transfert est confié au périphérique I2C1
+en mode interruption (HAL_I2C_Master_Transmit_IT / Receive_IT) :
+l'interruption I2C1, gérée par la librairie Wire, fait avancer les octets
+pendant que le processeur exécute les autres tâches ou dort en WFI.
+bus_i2c_executer() ne fait que lancer une transaction, constater la fin
+de l'étape en cours (état HAL_I2C_STATE_READY) et appeler la fonction de
+rappel depuis la tâche, jamais depuis l'interruption. La réception CAN,
+faite par interruption, n'est jamais bloquée.
+
+Une seule transaction est en cours à la fois. Les accès bloquants de
+TwoWire (détection des capteurs, beginI2C() des librairies SparkFun)
+attendent que le bus soit au repos, voir bus_i2c_au_repos().
+
+Récupération du bus : un esclave qui tient SDA à l'état bas (transfert
+interrompu, parasites des moteurs) bloque toutes les transactions. Le
+délai des transferts bloquants de la librairie est ramené à
+I2C_TIMEOUT_TICK (5 ms, voir platformio.ini) et une transaction en
+erreur de bus, refusée par le périphérique, non terminée après
+BUS_I2C_DELAI_MAX_US ou trouvant SDA bas au repos déclenche
+bus_i2c_recuperer() : 9 impulsions sur SCL pour terminer l'octet en
+cours de l'esclave, une condition STOP, puis la remise à zéro du
+périphérique I2C1. L'opération dure une centaine de µs, sans redémarrer
+la carte.
+*/
+
+#ifndef BUS_I2C_H
+#define BUS_I2C_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <Wire.h>
+#include "instrumentation.h"
+
+// Fréquence du bus : ADS7828, BME280 et SCD41 supportent tous le Fast Mode
+#define BUS_I2C_FREQUENCE 400000
+
+// Broches du bus (I2C1)
+#define BUS_I2C_SDA PB7
+#define BUS_I2C_SCL PB6
+
+// Durée au-delà de laquelle une transaction est considérée bloquée (µs)
+#define BUS_I2C_DELAI_MAX_US 2000
+
+// Nombre de transactions en attente (puissance de 2)
+#define BUS_I2C_TAILLE_FILE 8
+
+// Tailles maximales des données écrites et lues par transaction
+#define BUS_I2C_MAX_ECRITURE 4
+#define BUS_I2C_MAX_LECTURE 9
+
+/*
+ * Type : FinTransactionI2C
+ * But : Fonction appelée à la fin d'une transaction
+ * Paramètres :
+ *    - lecture : octets lus (nb_lecture octets)
+ *    - reussie : false si l'esclave n'a pas répondu ou a renvoyé moins d'octets
+ *    - contexte : valeur fournie lors de la soumission
+ */
+typedef void (*FinTransactionI2C)(const uint8_t *lecture, bool reussie, uint32_t contexte);
+
+/*
+ * Structure : TransactionI2C
+ * But : Écriture de nb_ecriture octets puis lecture de nb_lecture octets
+ */
+struct TransactionI2C
+{
+    uint8_t adresse;
+    uint8_t ecriture[BUS_I2C_MAX_ECRITURE];
+    uint8_t nb_ecriture;
+    uint8_t nb_lecture;
+    FinTransactionI2C fin;
+    uint32_t contexte;
+    PointMesure point; // étape à laquelle la durée de la transaction est attribuée
+};
+
+/*
+ * Fonction : bus_i2c_init
+ * But : Démarre le bus I2C en Fast Mode
+ * Paramètres :
+ *    - bus : bus I2C utilisé par tous les capteurs
+ */
+void bus_i2c_init(TwoWire &bus);
+
+/*
+ * Fonction : bus_i2c_soumettre
+ * But : Ajoute une transaction à la file
+ * Retour :
+ *    - false si la file est pleine (la transaction n'est pas ajoutée)
+ */
+bool bus_i2c_soumettre(const TransactionI2C &transaction);
+
+/*
+ * Fonction : bus_i2c_executer
+ * But : Fait avancer la transaction en cours (lecture après l'écriture, fin
+ *       constatée : fonction de rappel) puis lance la suivante de la file
+ */
+void bus_i2c_executer();
+
+// Indique si une transaction est à lancer ou si l'étape en cours est terminée
+bool bus_i2c_en_attente();
+
+// Indique qu'aucun transfert n'est en cours : TwoWire peut être utilisé directement
+bool bus_i2c_au_repos();
+
+// Nombre de transactions qui peuvent encore être soumises
+size_t bus_i2c_places_libres();
+
+/*
+ * Fonction : bus_i2c_recuperer
+ * But : Libère un bus bloqué (9 impulsions SCL, STOP) et réinitialise le
+ *       périphérique I2C, sans redémarrer la carte
+ */
+void bus_i2c_recuperer();
+
+// Nombre de récupérations du bus depuis le démarrage
+uint32_t bus_i2c_recuperations();
+
+// Transactions en erreur de bus ou trop longues (hors absence d'acquittement)
+uint32_t bus_i2c_erreurs();
+
+// Transactions sans acquittement : adresse ou octet refusé, ou lecture incomplète
+uint32_t bus_i2c_nacks();
+
+// Transactions exécutées depuis le démarrage
+uint32_t bus_i2c_transactions();
+
+#endif
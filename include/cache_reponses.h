@@ -0,0 +1,66 @@
+/*
+Modèles de trames de réponse et regroupement des requêtes
+
+Une image complète des données encodées (toutes les données, à leur
+position fixe dans 0x1A5/0x1A6) est tenue à jour donnée par donnée :
+seuls les octets d'une donnée dont la valeur a changé sont réencodés.
+Pour chaque masque demandé récemment, des trames 0x1A5/0x1A6 prêtes à
+envoyer sont conservées ; une requête ne fait que recopier dans ces
+modèles les octets des données modifiées, puis les trames sont passées
+directement à la file d'émission (voir can_tx.h).
+
+Les octets d'un modèle sont réutilisés tant que chaque donnée demandée est
+plus récente que sa fenêtre de fraîcheur. Les capteurs des données trop
+anciennes sont relus au prochain passage (voir acquisition_rafraichir()).
+Par défaut, la fenêtre de chaque donnée correspond à la période
+d'acquisition de son capteur ; la commande 0x04 permet de la modifier.
+La période de lecture du profil du BME280 est un minimum pour la fenêtre
+de la température, de l'humidité et de la pression : une fenêtre plus
+courte est allongée à cette période sans que la valeur configurée change.
+
+La trame 0x1A6 est envoyée si et seulement si le masque demande la
+pression, quelle que soit la valeur encodée.
+*/
+
+#ifndef CACHE_REPONSES_H
+#define CACHE_REPONSES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "STM32_CAN.h"
+#include "protocole.h"
+
+// Nombre de masques différents dont les trames sont conservées
+#define CACHE_NB_MODELES 4
+
+/*
+ * Fonction : cache_reponse
+ * But : Met à jour et donne les trames de réponse correspondant à un masque
+ * Paramètres :
+ *    - masque : un octet 0x11 par donnée désirée
+ *    - longueur : nombre d'octets du masque
+ *    - maintenant : temps courant en ms (millis())
+ *    - trames : reçoit les trames à envoyer, dans l'ordre (0x1A5 puis 0x1A6)
+ * Retour :
+ *    - nombre de trames à envoyer (1 ou 2)
+ */
+uint8_t cache_reponse(const uint8_t *masque, size_t longueur, uint32_t maintenant, CAN_message_t *trames[2]);
+
+/*
+ * Fonction : cache_modifier_fenetre
+ * But : Change la fenêtre de fraîcheur d'une donnée
+ * Retour :
+ *    - false si la donnée n'existe pas
+ */
+bool cache_modifier_fenetre(uint8_t donnee, uint16_t fenetre_ms);
+
+/*
+ * Fonction : cache_modifier_fenetre_minimale
+ * But : Change la durée en dessous de laquelle la fenêtre d'une donnée est
+ *       allongée (période de lecture de son capteur, 0 : aucun minimum)
+ * Retour :
+ *    - false si la donnée n'existe pas
+ */
+bool cache_modifier_fenetre_minimale(uint8_t donnee, uint16_t minimum_ms);
+
+#endif
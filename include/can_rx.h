@@ -0,0 +1,77 @@
+/*
+Réception CAN par interruption
+
+L'interruption CAN1_RX0 vide la FIFO matérielle (3 trames seulement) dans
+un tampon circulaire sans verrou. La boucle principale vide ce tampon à son
+rythme : une lecture I2C qui bloque loop() quelques millisecondes ne fait
+plus perdre de requêtes.
+
+La librairie STM32_CAN 1.1.x n'offre pas de fonction de rappel en réception ;
+son gestionnaire CAN1_RX0 est donc remplacé (voir vecteurs.h). Can.read()
+ne reçoit plus rien une fois can_rx_init() appelée ; l'émission reste
+assurée par la librairie.
+
+Le filtre d'acceptation matériel rejette les trames des autres nœuds avant
+la FIFO : elles ne déclenchent plus d'interruption.
+*/
+
+#ifndef CAN_RX_H
+#define CAN_RX_H
+
+#include <stdint.h>
+#include "STM32_CAN.h"
+
+// Profondeur du tampon de réception (puissance de 2)
+#define CAN_RX_TAILLE_ANNEAU 64
+
+/*
+ * Fonction : can_rx_init
+ * But : Installe le gestionnaire d'interruption de réception
+ *       (à appeler après Can.begin() et Can.setBaudRate())
+ */
+void can_rx_init();
+
+/*
+ * Fonction : can_rx_filtrer
+ * But : Ajoute une banque de filtre d'acceptation du bxCAN : les trames dont
+ *       l'identifiant standard correspond à id sur les bits de masque
+ *       atteignent la FIFO0. Le premier appel désactive toutes les autres
+ *       banques (à appeler après Can.setBaudRate(), qui remet les filtres à
+ *       leur valeur par défaut)
+ * Paramètres :
+ *    - can : contrôleur CAN de la librairie
+ *    - id : identifiant de référence
+ *    - masque : bits de l'identifiant qui doivent correspondre (0x7FF : identifiant exact)
+ * Retour :
+ *    - false si toutes les banques sont utilisées
+ */
+bool can_rx_filtrer(STM32_CAN &can, uint32_t id, uint32_t masque);
+
+/*
+ * Fonction : can_rx_lire
+ * But : Retire la plus ancienne trame reçue
+ * Paramètres :
+ *    - message : trame reçue (valide seulement si la fonction retourne true) ;
+ *                timestamp contient les 16 bits de poids faible de millis()
+ *                à la réception
+ * Retour :
+ *    - false si aucune trame n'est en attente
+ */
+bool can_rx_lire(CAN_message_t &message);
+
+// Indique si des trames attendent d'être lues
+bool can_rx_en_attente();
+
+// Valeur de cycles_lire() au début de la dernière interruption de réception
+uint32_t can_rx_cycles_interruption();
+
+// Trames acceptées par le filtre et copiées par l'interruption (perdues comprises)
+uint32_t can_rx_recues();
+
+// Trames perdues parce que le tampon logiciel était plein
+uint32_t can_rx_debordements_anneau();
+
+// Débordements signalés par la FIFO matérielle (bit FOVR0)
+uint32_t can_rx_debordements_fifo();
+
+#endif
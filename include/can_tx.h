@@ -0,0 +1,68 @@
+/*
+Émission CAN par files de priorité
+
+Chaque trame à émettre est copiée dans la file de sa classe de priorité,
+puis l'interruption CAN1_TX charge les boîtes d'émission libres du bxCAN
+(bits TME du registre TSR) en prenant toujours la trame la plus prioritaire.
+La boucle principale n'attend jamais une boîte libre et peut réutiliser sa
+trame dès le retour de can_tx_envoyer().
+
+Comme pour la réception (voir can_rx.h), le gestionnaire CAN1_TX de la
+librairie STM32_CAN est remplacé : Can.write() ne doit plus être appelée
+une fois can_tx_init() appelée. L'émission est mise en mode FIFO (bit TXFP)
+pour que les trames d'un même identifiant, comme les segments de
+l'historique, partent dans l'ordre où elles ont été chargées ; la priorité
+entre classes est assurée par les files.
+*/
+
+#ifndef CAN_TX_H
+#define CAN_TX_H
+
+#include <stdint.h>
+#include "STM32_CAN.h"
+
+// Profondeur de chaque file d'émission (puissance de 2)
+#define CAN_TX_TAILLE_FILE 16
+
+// Classes de priorité, de la plus prioritaire à la moins prioritaire
+enum PrioriteTx
+{
+    PRIORITE_ALARME,     // changements d'état des alarmes
+    PRIORITE_REPONSE,    // réponses aux requêtes et aux commandes
+    PRIORITE_DIFFUSION,  // mode diffusion, réponse de groupe, état des capteurs
+    PRIORITE_HISTORIQUE, // segments d'un transfert d'historique
+    PRIORITE_DIAGNOSTIC, // statistiques de diagnostic
+    NB_PRIORITES_TX
+};
+
+/*
+ * Fonction : can_tx_init
+ * But : Installe le gestionnaire d'interruption d'émission et passe le bxCAN
+ *       en émission FIFO (à appeler après Can.begin() et Can.setBaudRate())
+ */
+void can_tx_init();
+
+/*
+ * Fonction : can_tx_envoyer
+ * But : Copie une trame dans la file de sa priorité et relance l'émission
+ * Paramètres :
+ *    - trame : trame à émettre
+ *    - priorite : classe de priorité de la trame
+ * Retour :
+ *    - false si la file est pleine (la trame n'est pas émise)
+ */
+bool can_tx_envoyer(const CAN_message_t &trame, PrioriteTx priorite);
+
+// Trames transmises avec succès sur le bus
+uint32_t can_tx_envoyees();
+
+// Trames perdues parce que leur file était pleine
+uint32_t can_tx_debordements();
+
+// Transmissions terminées sans succès (arbitrage perdu ou erreur, TXOK à 0)
+uint32_t can_tx_echouees();
+
+// Chargements interrompus faute de boîte libre, des trames restant en file
+uint32_t can_tx_boites_pleines();
+
+#endif
@@ -0,0 +1,114 @@
+/*
+Disponibilité des capteurs et démarrage en mode dégradé
+
+Aucun capteur n'est initialisé dans setup() : le nœud répond sur le CAN
+dès le démarrage, quel que soit l'état des capteurs. La tâche de
+surveillance initialise ensuite chaque capteur, un seul par exécution ;
+un capteur absent est détecté par l'absence d'acquittement de son adresse
+en quelques dizaines de µs, sans attendre les délais de sa librairie.
+
+Un capteur qui ne produit plus de mesure pendant CAPTEUR_SILENCE_..._MS
+est déclaré indisponible. Les capteurs indisponibles sont réessayés avec
+un délai qui double à chaque échec (CAPTEURS_ATTENTE_MIN_MS à
+CAPTEURS_ATTENTE_MAX_MS). Les données d'un capteur indisponible valent
+0xFF dans les réponses 0x1A5/0x1A6 ; la température et l'humidité restent
+servies tant que le BME280 ou le SCD41 répond.
+
+Trame d'état (ID base + 0xC, 0x1AC pour le nœud 0), envoyée à chaque
+changement et toutes les CAPTEURS_PERIODE_ETAT_MS tant qu'un capteur est
+indisponible :
+    Octet #0 : capteurs disponibles (bit 0 ADS7828, bit 1 BME280, bit 2 SCD41)
+    Octets #1 à #3 : nombre de tentatives d'initialisation échouées de
+                     chaque capteur, dans le même ordre (saturé à 255)
+
+Le démarrage du SCD41 (~530 ms d'attentes imposées par le capteur) est
+déroulé par son pilote sur la file I2C (voir scd41.h) : il n'est lancé
+qu'une fois le capteur vu sur le bus. Le SCD41 n'est déclaré disponible
+qu'à sa première mesure (~5 s plus tard) ; une étape en échec, ou aucune
+mesure pendant CAPTEUR_SILENCE_SCD41_MS, compte comme une tentative
+échouée et double le délai avant la suivante.
+*/
+
+#ifndef CAPTEURS_H
+#define CAPTEURS_H
+
+#include <stdint.h>
+#include "donnees.h"
+#include "scd41.h"
+
+// Délais de réessai d'un capteur indisponible (ms)
+#define CAPTEURS_ATTENTE_MIN_MS 1000
+#define CAPTEURS_ATTENTE_MAX_MS 60000
+
+// Durée sans mesure au-delà de laquelle un capteur est déclaré indisponible (ms)
+#define CAPTEUR_SILENCE_ADS7828_MS 200
+#define CAPTEUR_SILENCE_BME280_MS 2000
+#define CAPTEUR_SILENCE_SCD41_MS (SCD41_BASSE_CONSOMMATION ? 90000 : 15000) // 3 mesures
+
+// Période de la trame d'état tant qu'un capteur est indisponible (ms)
+#define CAPTEURS_PERIODE_ETAT_MS 1000
+
+// Taille de la trame d'état
+#define CAPTEURS_TAILLE_ETAT 4
+
+/*
+ * Fonction : capteurs_init
+ * But : Déclare tous les capteurs indisponibles et planifie leur
+ *       initialisation immédiate par capteurs_surveiller()
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void capteurs_init(uint32_t maintenant);
+
+/*
+ * Fonction : capteurs_surveiller
+ * But : Déclare indisponibles les capteurs silencieux et tente d'initialiser
+ *       le premier capteur indisponible dont le délai de réessai est écoulé
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void capteurs_surveiller(uint32_t maintenant);
+
+// Indique si un capteur est initialisé et produit des mesures
+bool capteur_disponible(Capteur capteur);
+
+// Indique si le pilote d'un capteur doit être exécuté (disponible ou en démarrage)
+bool capteur_en_service(Capteur capteur);
+
+/*
+ * Fonction : capteur_actif
+ * But : Signale qu'un capteur vient de produire une mesure ; un capteur en
+ *       démarrage devient disponible
+ */
+void capteur_actif(Capteur capteur, uint32_t maintenant);
+
+// Indique si au moins un capteur fournit une donnée
+bool capteurs_donnee_disponible(Donnee donnee);
+
+// Données fournies par au moins un capteur (bit i : donnée i, voir encoder_compact())
+uint8_t capteurs_donnees_disponibles();
+
+/*
+ * Fonction : capteurs_age_ms
+ * But : Temps écoulé depuis la dernière mesure d'un capteur
+ * Retour :
+ *    - UINT32_MAX si le capteur est indisponible
+ */
+uint32_t capteurs_age_ms(Capteur capteur, uint32_t maintenant);
+
+// Adresse I2C du BME280 retenue à sa dernière initialisation (voir configuration.h)
+uint8_t capteurs_adresse_bme280();
+
+/*
+ * Fonction : capteurs_etat_a_publier
+ * But : Indique si la trame d'état doit être envoyée (changement ou rappel périodique)
+ */
+bool capteurs_etat_a_publier(uint32_t maintenant);
+
+/*
+ * Fonction : capteurs_trame_etat
+ * But : Prépare la trame d'état (CAPTEURS_TAILLE_ETAT octets)
+ */
+void capteurs_trame_etat(uint8_t donnees[8]);
+
+#endif
@@ -0,0 +1,79 @@
+/*
+Commandes de configuration reçues sur l'ID 0x1A9
+
+Octet #0 : code de la commande ; les octets suivants dépendent de la commande.
+Chaque commande reçoit une réponse sur l'ID 0x1AA :
+    Octet #0 : code de la commande
+    Octet #1 : statut (0x00 succès, 0x01 erreur)
+    Octets #2 et suivants : données retournées, le cas échéant
+
+Les valeurs multi-octets sont envoyées LSB en premier.
+
+Commandes :
+    0x01 Écrire R0 : octet #1 capteur (0 méthane, 1 CO), octets #2 à #5 R0 en ohms
+         (sauvegardé en flash)
+    0x02 Lire R0   : octet #1 capteur
+         réponse : octet #2 capteur, octets #3 à #6 R0 en ohms
+    0x03 Format de réponse : octet #1 = 0 standard (0x1A5/0x1A6),
+         1 compact (toutes les données dans une trame 0x1AB, voir protocole.h)
+    0x04 Fenêtre de fraîcheur : octet #1 donnée (0 à 5, ordre du masque),
+         octets #2 et #3 fenêtre en ms (voir cache_reponses.h)
+    0x05 Écrire un seuil d'alarme : octet #1 donnée, octets #2-#3 seuil
+         (entier signé), octets #4-#5 hystérésis, octet #6 = 1 actif,
+         0 désactivé (voir alarmes.h) ; refusé si seuil - hystérésis
+         sort d'un entier signé 16 bits (sauvegardé en flash)
+    0x06 Lire un seuil d'alarme : octet #1 donnée
+         réponse : octet #2 donnée, octets #3-#4 seuil, octets #5-#6
+         hystérésis, octet #7 actif
+    0x07 Lire un champ de configuration : octet #1 champ, octet #2 index
+         réponse : octet #2 champ, octet #3 index, octets #4 à #7 valeur
+         (liste des champs dans configuration.h)
+    0x08 Écrire un champ de configuration : octet #1 champ, octet #2 index,
+         octets #3 à #6 valeur (appliqué en RAM, non sauvegardé)
+    0x09 Sauvegarder la configuration en flash
+    0x0A Rétablir la configuration par défaut (en RAM ; 0x09 pour la sauvegarder)
+
+Les commandes 0x03 et 0x04 modifient la configuration en RAM comme 0x08 ;
+0x01 et 0x05 la sauvegardent aussi.
+*/
+
+#ifndef COMMANDES_H
+#define COMMANDES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "protocole.h"
+
+// Codes de commande
+#define CMD_ECRIRE_R0 0x01
+#define CMD_LIRE_R0 0x02
+#define CMD_FORMAT 0x03
+#define CMD_FENETRE 0x04
+#define CMD_ECRIRE_SEUIL 0x05
+#define CMD_LIRE_SEUIL 0x06
+#define CMD_LIRE_CHAMP 0x07
+#define CMD_ECRIRE_CHAMP 0x08
+#define CMD_SAUVEGARDER 0x09
+#define CMD_DEFAUTS 0x0A
+
+// Statuts de réponse
+#define CMD_STATUT_OK 0x00
+#define CMD_STATUT_ERREUR 0x01
+
+/*
+ * Fonction : commande_traiter
+ * But : Exécute une commande et prépare sa réponse
+ * Paramètres :
+ *    - donnees : champ de données de la trame reçue
+ *    - longueur : nombre d'octets reçus
+ *    - reponse : tableau de 8 octets recevant la réponse
+ *    - maintenant : temps courant en ms (millis())
+ * Retour :
+ *    - nombre d'octets de la réponse (0 si aucune réponse ne doit être envoyée)
+ */
+uint8_t commande_traiter(const uint8_t *donnees, size_t longueur, uint8_t reponse[8], uint32_t maintenant);
+
+// Format de réponse de la configuration (commande 0x03 ou champ 0x0B)
+FormatReponse commande_format();
+
+#endif
@@ -0,0 +1,181 @@
+/*
+Configuration persistante de la carte
+
+Tous les réglages modifiables sur le terrain sont regroupés dans un bloc
+versionné (struct Configuration) conservé dans le journal de stockage
+(deux secteurs flash utilisés à tour de rôle, CRC-32 et répartition de
+l'usure, voir stockage.h).
+Le bloc est chargé dans setup() en une seule lecture ; en son absence
+(première mise en service, version différente), les valeurs de compilation
+sont utilisées et les R0 d'une ancienne sauvegarde sont repris.
+
+Les champs se lisent et s'écrivent par les commandes 0x07 et 0x08 (voir
+commandes.h) ; une écriture prend effet immédiatement en RAM, sauf pour
+les champs marqués « au démarrage », et n'est conservée qu'après la
+commande 0x09 (sauvegarde).
+
+Champs (valeur sur 32 bits, LSB en premier ; index = capteur de gaz ou donnée) :
+    0x00 Version du bloc (lecture seule)
+    0x01 Débit CAN en bit/s : 125000, 250000, 500000 ou 1000000 (au démarrage)
+    0x02 Base des identifiants CAN, alignée sur 16 (au démarrage, voir adressage.h)
+    0x03 Adresse I2C du BME280 : 0x76 ou 0x77 (à la prochaine initialisation du capteur)
+    0x04 R0 d'un capteur de gaz en ohms (index 0 méthane, 1 CO)
+    0x05 Pente m de la courbe d'un capteur de gaz, en millièmes (entier signé)
+    0x06 Ordonnée b de la courbe d'un capteur de gaz, en millièmes (entier signé)
+    0x07 Fenêtre de fraîcheur d'une donnée en ms (voir cache_reponses.h) ;
+         celle des données du BME280 est allongée, sans être modifiée,
+         jusqu'à la période de son profil
+    0x08 Seuil d'alarme d'une donnée (entier signé, voir alarmes.h)
+    0x09 Hystérésis de l'alarme d'une donnée
+    0x0A Alarme d'une donnée active (1) ou désactivée (0)
+    0x0B Format de réponse : 0 standard, 1 compact
+    0x0C Données publiées par le mode diffusion (bit i = donnée i)
+    0x0D Période du mode diffusion en ms (0 : désactivé)
+    0x0E Profil du BME280 : 0 rapide, 1 équilibré, 2 précis (voir bme280_profils.h)
+
+La trame 0x1A3 (voir diffusion.h) change la diffusion jusqu'au prochain
+démarrage sans toucher à la configuration.
+*/
+
+#ifndef CONFIGURATION_H
+#define CONFIGURATION_H
+
+#include <stdint.h>
+#include "conversion_gaz.h"
+#include "mesures.h"
+
+// Version du bloc : à incrémenter à chaque changement de la structure
+// (2 : profil du BME280, placé dans l'alignement de la version 1)
+#define CONFIGURATION_VERSION 2
+
+// Débit CAN par défaut (bit/s)
+#define CONFIGURATION_DEBIT_CAN 500000
+
+// Champs lus et écrits par les commandes 0x07 et 0x08
+enum ChampConfiguration
+{
+    CHAMP_VERSION,
+    CHAMP_DEBIT_CAN,
+    CHAMP_BASE_CAN,
+    CHAMP_ADRESSE_BME280,
+    CHAMP_R0,
+    CHAMP_PENTE,
+    CHAMP_ORDONNEE,
+    CHAMP_FENETRE,
+    CHAMP_SEUIL,
+    CHAMP_HYSTERESIS,
+    CHAMP_ALARME_ACTIVE,
+    CHAMP_FORMAT,
+    CHAMP_DIFFUSION_DONNEES,
+    CHAMP_DIFFUSION_PERIODE,
+    CHAMP_PROFIL_BME280,
+    NB_CHAMPS
+};
+
+/*
+ * Structure : SeuilConfigure
+ * But : Réglage de l'alarme d'une donnée
+ */
+struct SeuilConfigure
+{
+    int16_t seuil;
+    uint16_t hysteresis;
+    uint8_t active;
+};
+
+/*
+ * Structure : Configuration
+ * But : Contenu du bloc sauvegardé en flash
+ */
+struct Configuration
+{
+    uint16_t version;
+    uint8_t adresse_bme280;
+    uint8_t format;
+    uint32_t debit_can;
+    uint16_t base_can;
+    uint16_t periode_diffusion_ms;
+    uint8_t diffusion_donnees; // bit i : donnée i publiée
+    uint8_t profil_bme280;     // ProfilBme280
+    CourbeGaz courbes[NB_GAZ];
+    uint16_t fenetres_ms[NB_DONNEES];
+    SeuilConfigure seuils[NB_DONNEES];
+};
+
+/*
+ * Fonction : configuration_charger
+ * But : Lit le bloc sauvegardé, ou prend les valeurs par défaut s'il est
+ *       absent ou d'une autre version
+ * Retour :
+ *    - configuration chargée (champs lus par setup() avant l'initialisation du CAN)
+ */
+const Configuration &configuration_charger();
+
+// Configuration courante
+const Configuration &configuration();
+
+/*
+ * Fonction : configuration_appliquer
+ * But : Transmet les champs pris en compte immédiatement aux modules
+ *       (tables de conversion, fenêtres, alarmes, diffusion)
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void configuration_appliquer(uint32_t maintenant);
+
+/*
+ * Fonction : configuration_lire_champ
+ * But : Lit un champ de la configuration courante
+ * Paramètres :
+ *    - champ : ChampConfiguration
+ *    - index : capteur de gaz ou donnée, pour les champs qui en ont un
+ *    - valeur : reçoit la valeur du champ
+ * Retour :
+ *    - false si le champ ou l'index n'existe pas
+ */
+bool configuration_lire_champ(uint8_t champ, uint8_t index, uint32_t &valeur);
+
+/*
+ * Fonction : configuration_ecrire_champ
+ * But : Modifie un champ en RAM et l'applique s'il prend effet immédiatement
+ * Paramètres :
+ *    - champ : ChampConfiguration
+ *    - index : capteur de gaz ou donnée, pour les champs qui en ont un
+ *    - valeur : nouvelle valeur
+ *    - maintenant : temps courant en ms (millis())
+ * Retour :
+ *    - false si le champ, l'index ou la valeur est invalide (rien n'est modifié)
+ */
+bool configuration_ecrire_champ(uint8_t champ, uint8_t index, uint32_t valeur, uint32_t maintenant);
+
+/*
+ * Fonction : configuration_ecrire_seuil
+ * But : Remplace d'un bloc le réglage d'alarme d'une donnée, l'applique et
+ *       le sauvegarde par une seule écriture du journal
+ * Paramètres :
+ *    - donnee : donnée surveillée
+ *    - seuil, hysteresis, active : réglage complet (voir alarmes.h)
+ * Retour :
+ *    - false si la donnée est invalide ou seuil - hystérésis sort d'un int16_t
+ *      (rien n'est modifié), ou si l'écriture en flash a échoué
+ */
+bool configuration_ecrire_seuil(uint8_t donnee, int16_t seuil, uint16_t hysteresis, bool active);
+
+/*
+ * Fonction : configuration_sauvegarder
+ * But : Ajoute la configuration courante au journal de stockage
+ * Retour :
+ *    - false si l'écriture en flash a échoué
+ */
+bool configuration_sauvegarder();
+
+/*
+ * Fonction : configuration_defauts
+ * But : Remet en RAM les valeurs de compilation et les applique
+ *       (la flash n'est modifiée qu'à la prochaine sauvegarde)
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void configuration_defauts(uint32_t maintenant);
+
+#endif
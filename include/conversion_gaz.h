@@ -0,0 +1,159 @@
+/*
+Conversion des lectures des capteurs de gaz en ppm
+
+Chaque capteur possède son propre descripteur de calibration (courbe,
+tension de référence et résolution de l'ADC, pont diviseur éventuel devant
+l'ADC, résistance de charge, R0).
+Le calcul de computePPM() (log10 et pow) coûte des milliers de cycles par
+échantillon : une table d'une entrée par code ADC est donc calculée à
+partir du descripteur au démarrage, puis recalculée seulement lorsque la
+calibration change. Une conversion ne coûte alors qu'une lecture indexée.
+
+Ce module ne dépend d'aucune librairie matérielle (hors banc d'essai) ; la
+sauvegarde des courbes en flash est faite par configuration.h.
+*/
+
+#ifndef CONVERSION_GAZ_H
+#define CONVERSION_GAZ_H
+
+#include <stdint.h>
+
+// Nombre maximal de codes d'un ADC (12 bits)
+#define CONVERSION_NB_CODES 4096
+
+// Capteurs de gaz disposant d'une table de conversion
+enum CapteurGaz
+{
+    GAZ_METHANE, // SEN-0094
+    GAZ_CO,      // MQ7
+    NB_GAZ
+};
+
+/*
+ * Structure : CalibrationGaz
+ * But : Paramètres de conversion d'un capteur de gaz résistif
+ *       ppm = 10 ^ ((log10(RS / R0) - b) / m), avec RS = RL * (Vc - V) / V
+ *       et V = code * vref / 2^resolution * pont (tension en sortie du capteur)
+ */
+struct CalibrationGaz
+{
+    float m;            // pente de la courbe log-log de la fiche technique
+    float b;            // ordonnée à l'origine de la courbe
+    float vref;         // tension pleine échelle de l'ADC (V)
+    float pont;         // tension du capteur / tension à l'entrée de l'ADC (1 sans pont diviseur)
+    float vc;           // tension d'alimentation du capteur (V)
+    float rl_kohm;      // résistance de charge (kΩ)
+    float r0_kohm;      // résistance du capteur dans l'air propre (kΩ)
+    uint8_t resolution; // résolution de l'ADC (bits, 12 au plus)
+};
+
+/*
+ * Structure : CourbeGaz
+ * But : Paramètres réglables d'un capteur (voir configuration.h)
+ */
+struct CourbeGaz
+{
+    float m;       // pente de la courbe log-log
+    float b;       // ordonnée à l'origine
+    float r0_kohm; // résistance dans l'air propre (kΩ)
+};
+
+// Tables de conversion code ADC -> ppm (remplies par conversion_init())
+extern uint16_t table_ppm[NB_GAZ][CONVERSION_NB_CODES];
+
+/*
+ * Fonction : computePPM
+ * But : Calcule une concentration en ppm à partir d'une lecture brute du capteur analogique
+ *       (calcul de référence utilisé pour remplir les tables)
+ * Paramètres :
+ *    - calibration : descripteur du capteur
+ *    - sensorValue : code brut de l'ADC
+ */
+uint16_t computePPM(const CalibrationGaz &calibration, float sensorValue);
+
+/*
+ * Fonction : conversion_init
+ * But : Applique les courbes configurées et remplit les tables de conversion
+ * Paramètres :
+ *    - courbes : courbe de chaque capteur (NB_GAZ valeurs, les pentes nulles
+ *                et les R0 non positifs sont ignorés), ou nullptr pour les
+ *                valeurs par défaut
+ */
+void conversion_init(const CourbeGaz *courbes);
+
+/*
+ * Fonction : conversion_modifier_r0
+ * But : Change R0 d'un capteur et recalcule sa table
+ * Paramètres :
+ *    - capteur : capteur à modifier
+ *    - r0_kohm : nouvelle valeur de R0 (kΩ, strictement positive)
+ * Retour :
+ *    - false si la valeur est invalide
+ */
+bool conversion_modifier_r0(CapteurGaz capteur, float r0_kohm);
+
+/*
+ * Fonction : conversion_modifier_courbe
+ * But : Change la courbe d'un capteur et recalcule sa table
+ * Paramètres :
+ *    - capteur : capteur à modifier
+ *    - m : pente (non nulle)
+ *    - b : ordonnée à l'origine
+ * Retour :
+ *    - false si la valeur est invalide
+ */
+bool conversion_modifier_courbe(CapteurGaz capteur, float m, float b);
+
+// Descripteur courant d'un capteur
+const CalibrationGaz &conversion_calibration(CapteurGaz capteur);
+
+// Descripteur par défaut d'un capteur (valeurs de compilation)
+const CalibrationGaz &conversion_calibration_defaut(CapteurGaz capteur);
+
+/*
+ * Fonction : conversion_ppm
+ * But : Convertit un code ADC en ppm par simple lecture dans la table
+ * Paramètres :
+ *    - capteur : capteur de gaz ayant produit le code
+ *    - code : lecture brute (saturée à la taille de la table)
+ */
+inline uint16_t conversion_ppm(CapteurGaz capteur, uint16_t code)
+{
+    return table_ppm[capteur][code < CONVERSION_NB_CODES ? code : CONVERSION_NB_CODES - 1];
+}
+
+/*
+ * Fonction : conversion_ppm_interpolee
+ * But : Convertit une valeur suréchantillonnée en ppm par interpolation
+ *       linéaire entre deux entrées voisines de la table
+ * Paramètres :
+ *    - capteur : capteur de gaz ayant produit la valeur
+ *    - valeur : code ADC avec bits_fraction bits supplémentaires
+ *    - bits_fraction : nombre de bits sous le LSB de l'ADC
+ */
+inline uint16_t conversion_ppm_interpolee(CapteurGaz capteur, uint32_t valeur, uint8_t bits_fraction)
+{
+    uint32_t code = valeur >> bits_fraction;
+    if (code >= CONVERSION_NB_CODES - 1)
+        return table_ppm[capteur][CONVERSION_NB_CODES - 1];
+
+    int32_t bas = table_ppm[capteur][code];
+    int32_t haut = table_ppm[capteur][code + 1];
+    int32_t fraction = static_cast<int32_t>(valeur & ((1UL << bits_fraction) - 1));
+    return static_cast<uint16_t>(bas + ((haut - bas) * fraction >> bits_fraction));
+}
+
+#ifdef BANC_ESSAI_CONVERSION
+#include <Arduino.h>
+
+/*
+ * Fonction : conversion_banc_essai
+ * But : Compare en cycles (DWT->CYCCNT) le calcul direct et la table
+ *       sur les 4096 codes possibles et affiche le résultat
+ * Paramètres :
+ *    - sortie : port série sur lequel afficher le résultat
+ */
+void conversion_banc_essai(Print &sortie);
+#endif
+
+#endif
@@ -0,0 +1,29 @@
+/*
+Compteur de cycles du Cortex-M4 (DWT->CYCCNT)
+
+Permet de mesurer le coût d'une section de code en cycles d'horloge
+(180 cycles par microseconde à 180 MHz) sans débogueur branché.
+*/
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <Arduino.h>
+
+/*
+ * Fonction : cycles_init
+ * But : Active le compteur de cycles (sans effet s'il est déjà actif)
+ */
+inline void cycles_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+// Valeur courante du compteur (déborde toutes les ~24 s à 180 MHz)
+inline uint32_t cycles_lire()
+{
+    return DWT->CYCCNT;
+}
+
+#endif
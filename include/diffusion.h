@@ -0,0 +1,61 @@
+/*
+Mode diffusion (publication périodique)
+
+Une trame de configuration (ID 0x1A3) choisit les données à publier et la
+période. Le module envoie alors les trames 0x1A5/0x1A6 de lui-même, sans
+requête 0x1A4 du maître. Une période de 0 ms ramène le module au
+fonctionnement par requête uniquement.
+
+Au démarrage, les données et la période sont celles de la configuration
+(voir configuration.h) ; une trame 0x1A3 les remplace jusqu'au prochain
+démarrage.
+
+Trame de configuration (8 octets) :
+    Octets #0 à #5 : masque, 0x11 pour chaque donnée désirée (même
+                     convention que la requête 0x1A4)
+    Octet #6 : période en ms, LSB
+    Octet #7 : période en ms, MSB
+*/
+
+#ifndef DIFFUSION_H
+#define DIFFUSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "protocole.h"
+
+/*
+ * Fonction : diffusion_configurer
+ * But : Applique une trame de configuration reçue sur l'ID 0x1A3
+ * Paramètres :
+ *    - donnees : champ de données de la trame
+ *    - longueur : nombre d'octets reçus (8 attendus, sinon la trame est ignorée)
+ *    - maintenant : temps courant en ms (millis())
+ */
+void diffusion_configurer(const uint8_t *donnees, size_t longueur, uint32_t maintenant);
+
+/*
+ * Fonction : diffusion_definir
+ * But : Choisit les données publiées et la période
+ * Paramètres :
+ *    - donnees : bit i = donnée i publiée
+ *    - periode_ms : période en ms (0 : diffusion désactivée)
+ *    - maintenant : temps courant en ms (millis())
+ */
+void diffusion_definir(uint8_t donnees, uint16_t periode_ms, uint32_t maintenant);
+
+/*
+ * Fonction : diffusion_echeance
+ * But : Indique si une publication doit être envoyée maintenant
+ *       (la prochaine échéance est alors planifiée)
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ * Retour :
+ *    - true si le masque retourné par diffusion_masque() doit être publié
+ */
+bool diffusion_echeance(uint32_t maintenant);
+
+// Masque des données publiées (NB_DONNEES octets)
+const uint8_t *diffusion_masque();
+
+#endif
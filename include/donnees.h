@@ -0,0 +1,229 @@
+/*
+Table des données du projet capteur
+
+Une ligne par donnée (dans l'ordre de l'enum Donnee) décrit tout ce que les
+autres modules en dérivent à la compilation : largeur et champ encodé dans
+les trames 0x1A5/0x1A6, quantification du format compact, capteur source et
+période de rafraîchissement. La position des octets, la taille des trames,
+les fenêtres de fraîcheur du cache et les périodes des tâches d'acquisition
+sont calculées à partir de cette table.
+
+Ajouter une donnée (O2, COV...) revient à ajouter une valeur à l'enum
+Donnee, un champ à la struct Mesures et une ligne à table_donnees ; les
+static_assert vérifient que les données tiennent toujours dans les trames
+0x1A5/0x1A6 et dans la trame compacte.
+Ce module ne dépend d'aucune librairie matérielle.
+*/
+
+#ifndef DONNEES_H
+#define DONNEES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mesures.h"
+
+// Capteurs qui produisent les données
+enum Capteur
+{
+    CAPTEUR_ADS7828, // méthane et CO (ADS7828 ou ADC interne, voir adc_interne.h)
+    CAPTEUR_BME280,  // température, humidité, pression
+    CAPTEUR_SCD41,   // CO2, température, humidité
+    NB_CAPTEURS
+};
+
+// Périodes de rafraîchissement de chaque capteur (ms)
+#define PERIODE_GAZ_MS 10            // ADS7828 ou ADC interne : MQ7 et SEN-0094 échantillonnés à 100 Hz
+#define PERIODE_BME280_MS 500        // BME280 : température, humidité, pression
+#define PERIODE_SCD41_MESURE_MS 5000 // SCD41 : une mesure toutes les 5 s
+
+/*
+ * Structure : ChampCompact
+ * But : Quantification d'une donnée dans le format compact
+ *       (valeur - origine) / pas, saturée à bits bits
+ */
+struct ChampCompact
+{
+    float origine;
+    float pas;
+    uint8_t bits;
+};
+
+/*
+ * Structure : DescripteurDonnee
+ * But : Description d'une donnée, produite par descripteur() à partir du champ de Mesures
+ */
+struct DescripteurDonnee
+{
+    uint8_t taille;                                                           // octets dans 0x1A5/0x1A6
+    float (*lire)(const Mesures &mesures);                                    // valeur dans son unité
+    void (*encoder)(const Mesures &mesures, uint8_t *memoire, size_t &index); // octets de la donnée
+    ChampCompact compact;                                                     // champ du format compact
+    Capteur source;       // capteur relu lorsque la donnée est trop ancienne
+    uint8_t fournisseurs; // capteurs capables de fournir la donnée (bit = Capteur)
+    uint16_t periode_ms;  // période de rafraîchissement, fenêtre de fraîcheur par défaut
+};
+
+// Bit d'un capteur dans DescripteurDonnee::fournisseurs
+#define FOURNISSEUR(capteur) static_cast<uint8_t>(1u << (capteur))
+
+/*
+ * Fonction : encoder_float_entier
+ * But : Convertit un float en un uint8_t en gardant uniquement la partie entière
+ * Paramètres :
+ *    - valeur : la valeur flottante à convertir
+ *    - memoire : tableau dans lequel stocker l'octet résultant
+ *    - index : position actuelle dans le tableau (sera automatiquement incrémentée)
+ */
+void encoder_float_entier(float valeur, uint8_t *memoire, size_t &index);
+
+/*
+ * Fonction : encoder_uint16
+ * But : Encode un entier 16 bits (uint16_t) en deux octets (LSB puis MSB)
+ * Paramètres :
+ *    - valeur : la valeur entière 16 bits à convertir
+ *    - memoire : tableau dans lequel stocker les deux octets
+ *    - index : position actuelle dans le tableau (sera automatiquement incrémentée de 2)
+ */
+void encoder_uint16(uint16_t valeur, uint8_t *memoire, size_t &index);
+
+template <uint16_t Mesures::*Champ>
+float lire_champ(const Mesures &mesures)
+{
+    return mesures.*Champ;
+}
+
+template <float Mesures::*Champ>
+float lire_champ(const Mesures &mesures)
+{
+    return mesures.*Champ;
+}
+
+// Entiers sur deux octets, LSB en premier
+template <uint16_t Mesures::*Champ>
+void encoder_champ(const Mesures &mesures, uint8_t *memoire, size_t &index)
+{
+    encoder_uint16(mesures.*Champ, memoire, index);
+}
+
+// Réels réduits à leur partie entière sur un octet
+template <float Mesures::*Champ>
+void encoder_champ(const Mesures &mesures, uint8_t *memoire, size_t &index)
+{
+    encoder_float_entier(mesures.*Champ, memoire, index);
+}
+
+/*
+ * Fonction : descripteur
+ * But : Construit la ligne d'une donnée ; la largeur et l'encodage découlent du type du champ
+ * Paramètres :
+ *    - Champ : champ de Mesures qui contient la donnée
+ *    - compact : quantification dans le format compact
+ *    - source : capteur relu lorsque la donnée est trop ancienne
+ *    - fournisseurs : capteurs capables de fournir la donnée
+ *    - periode_ms : période de rafraîchissement de la source
+ */
+template <uint16_t Mesures::*Champ>
+constexpr DescripteurDonnee descripteur(ChampCompact compact, Capteur source, uint8_t fournisseurs,
+                                        uint16_t periode_ms)
+{
+    return {2, lire_champ<Champ>, encoder_champ<Champ>, compact, source, fournisseurs, periode_ms};
+}
+
+template <float Mesures::*Champ>
+constexpr DescripteurDonnee descripteur(ChampCompact compact, Capteur source, uint8_t fournisseurs,
+                                        uint16_t periode_ms)
+{
+    return {1, lire_champ<Champ>, encoder_champ<Champ>, compact, source, fournisseurs, periode_ms};
+}
+
+// Une ligne par donnée, dans l'ordre de l'enum Donnee
+constexpr DescripteurDonnee table_donnees[] = {
+    // Méthane : pas de 20 ppm (0 à 10200 ppm)
+    descripteur<&Mesures::methane_ppm>({0.0f, 20.0f, 9}, CAPTEUR_ADS7828, FOURNISSEUR(CAPTEUR_ADS7828),
+                                       PERIODE_GAZ_MS),
+    // CO2 : pas de 10 ppm (0 à 10220 ppm)
+    descripteur<&Mesures::co2_ppm>({0.0f, 10.0f, 10}, CAPTEUR_SCD41, FOURNISSEUR(CAPTEUR_SCD41),
+                                   PERIODE_SCD41_MESURE_MS),
+    // CO : pas de 2 ppm (0 à 2044 ppm)
+    descripteur<&Mesures::co_ppm>({0.0f, 2.0f, 10}, CAPTEUR_ADS7828, FOURNISSEUR(CAPTEUR_ADS7828),
+                                  PERIODE_GAZ_MS),
+    // Température : pas de 0,1 °C à partir de -40,0 °C (-40,0 à 62,2 °C)
+    descripteur<&Mesures::temperature_c>({-40.0f, 0.1f, 10}, CAPTEUR_BME280,
+                                         FOURNISSEUR(CAPTEUR_BME280) | FOURNISSEUR(CAPTEUR_SCD41), PERIODE_BME280_MS),
+    // Humidité : pas de 0,1 % (0 à 102,2 %)
+    descripteur<&Mesures::humidite_pct>({0.0f, 0.1f, 10}, CAPTEUR_BME280,
+                                        FOURNISSEUR(CAPTEUR_BME280) | FOURNISSEUR(CAPTEUR_SCD41), PERIODE_BME280_MS),
+    // Pression : pas de 0,01 kPa à partir de 70,00 kPa (70,00 à 110,94 kPa)
+    descripteur<&Mesures::pression_kpa>({70.0f, 0.01f, 12}, CAPTEUR_BME280, FOURNISSEUR(CAPTEUR_BME280),
+                                        PERIODE_BME280_MS),
+};
+
+static_assert(sizeof(table_donnees) / sizeof(table_donnees[0]) == NB_DONNEES,
+              "table_donnees doit avoir une ligne par donnee");
+
+// Nombre d'octets de chaque donnée dans les trames 0x1A5/0x1A6
+constexpr size_t taille_donnee(Donnee donnee)
+{
+    return table_donnees[donnee].taille;
+}
+
+// Position du premier octet de chaque donnée (0 à 7 : 0x1A5, 8 et au-delà : 0x1A6)
+constexpr size_t position_donnee(Donnee donnee)
+{
+    size_t position = 0;
+    for (size_t i = 0; i < static_cast<size_t>(donnee); i++)
+    {
+        position += table_donnees[i].taille;
+    }
+    return position;
+}
+
+// Première position du champ d'une donnée dans le format compact (après la séquence sur 3 bits)
+constexpr uint8_t decalage_compact(Donnee donnee)
+{
+    uint8_t decalage = 3;
+    for (size_t i = 0; i < static_cast<size_t>(donnee); i++)
+    {
+        decalage = static_cast<uint8_t>(decalage + table_donnees[i].compact.bits);
+    }
+    return decalage;
+}
+
+// Données dont les octets sont dans la trame 0x1A6 (bit = Donnee)
+constexpr uint8_t donnees_trame_2()
+{
+    uint8_t masque = 0;
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (position_donnee(static_cast<Donnee>(i)) >= 8)
+            masque = static_cast<uint8_t>(masque | (1u << i));
+    }
+    return masque;
+}
+
+// Période de rafraîchissement la plus courte des données relues sur un capteur (ms)
+constexpr uint16_t periode_source(Capteur capteur)
+{
+    uint16_t periode = UINT16_MAX;
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (table_donnees[i].source == capteur && table_donnees[i].periode_ms < periode)
+            periode = table_donnees[i].periode_ms;
+    }
+    return periode;
+}
+
+static_assert(NB_DONNEES <= 8, "Le masque des donnees demandees tient sur un octet");
+static_assert(position_donnee(NB_DONNEES) <= 16, "Les donnees doivent tenir dans les trames 0x1A5/0x1A6");
+static_assert(decalage_compact(NB_DONNEES) <= 64, "Le format compact doit tenir dans une trame");
+
+/*
+ * Fonction : mesures_valeur
+ * But : Valeur d'une donnée dans son unité (ppm, °C, %, kPa)
+ */
+inline float mesures_valeur(const Mesures &mesures, Donnee donnee)
+{
+    return donnee < NB_DONNEES ? table_donnees[donnee].lire(mesures) : 0.0f;
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+Fusion de plusieurs capteurs d'une même grandeur (filtre de Kalman scalaire)
+
+La grandeur est modélisée comme une marche aléatoire : entre deux
+échantillons, l'incertitude de l'estimation croît de bruit_processus par
+seconde écoulée. Chaque échantillon est intégré dès son arrivée avec un
+gain K = P / (P + R), où R est la variance de mesure de sa source : une
+source précise pèse davantage, et un échantillon qui arrive après un long
+silence est suivi plus fortement qu'un échantillon rapproché.
+
+La source 0 sert de référence. Le décalage des autres sources (ex.
+l'auto-échauffement du SCD41) est appris lentement par rapport à
+l'estimation lorsque la référence a été vue depuis moins de
+reference_ms, puis retranché de leurs échantillons. Sans référence, les
+autres sources continuent de corriger l'estimation avec leur dernier
+décalage appris.
+
+Coût : quelques multiplications flottantes par échantillon, sans historique.
+*/
+
+#ifndef FUSION_H
+#define FUSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Structure : ParametresFusion
+ * But : Réglage du filtre pour une grandeur et N sources
+ */
+template <size_t N>
+struct ParametresFusion
+{
+    float variances[N];     // variance de mesure de chaque source (unité²)
+    float bruit_processus;  // croissance de la variance de l'estimation (unité² par seconde)
+    float gain_decalage;    // part de l'écart appris à chaque échantillon (0 à 1)
+    uint32_t reference_ms;  // fraîcheur de la référence requise pour apprendre un décalage
+};
+
+template <size_t N>
+class Fusion
+{
+    static_assert(N >= 1, "Au moins une source");
+
+public:
+    explicit constexpr Fusion(const ParametresFusion<N> &parametres) : parametres(parametres) {}
+
+    /*
+     * Fonction : ajouter
+     * But : Intègre un échantillon d'une source
+     * Paramètres :
+     *    - source : numéro de la source (0 : référence)
+     *    - valeur : échantillon brut de la source
+     *    - instant_ms : horodatage de l'échantillon (millis())
+     */
+    void ajouter(size_t source, float valeur, uint32_t instant_ms)
+    {
+        if (source >= N)
+            return;
+
+        if (source == 0)
+        {
+            reference_vue = true;
+            instant_reference = instant_ms;
+        }
+
+        float mesure = valeur - decalages[source];
+        float variance_mesure = parametres.variances[source];
+
+        if (!initialise)
+        {
+            estimation = mesure;
+            variance = variance_mesure;
+            instant = instant_ms;
+            initialise = true;
+            return;
+        }
+
+        // Prédiction : l'incertitude croît avec le temps écoulé depuis le dernier échantillon
+        int32_t ecart_ms = static_cast<int32_t>(instant_ms - instant);
+        if (ecart_ms > 0)
+        {
+            variance += parametres.bruit_processus * (ecart_ms / 1000.0f);
+            instant = instant_ms;
+        }
+
+        // Apprentissage du décalage, tant que la référence est fraîche
+        if (source != 0 && reference_vue && instant_ms - instant_reference <= parametres.reference_ms)
+        {
+            decalages[source] += parametres.gain_decalage * (mesure - estimation);
+            mesure = valeur - decalages[source];
+        }
+
+        // Correction
+        float gain = variance / (variance + variance_mesure);
+        estimation += gain * (mesure - estimation);
+        variance *= 1.0f - gain;
+    }
+
+    // Estimation courante (0 avant le premier échantillon)
+    float valeur() const { return estimation; }
+
+    // Décalage appris d'une source par rapport à la référence
+    float decalage(size_t source) const { return source < N ? decalages[source] : 0.0f; }
+
+    bool pret() const { return initialise; }
+
+private:
+    ParametresFusion<N> parametres;
+    float decalages[N] = {0};
+    float estimation = 0.0f;
+    float variance = 0.0f;
+    uint32_t instant = 0;
+    uint32_t instant_reference = 0;
+    bool reference_vue = false;
+    bool initialise = false;
+};
+
+#endif
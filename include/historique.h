@@ -0,0 +1,86 @@
+/*
+Historique des mesures et téléchargement segmenté
+
+Toutes les HISTORIQUE_PERIODE_MS, les six données sont encodées au format
+compact (voir protocole.h) et ajoutées, avec leur horodatage millis(), à un
+tampon circulaire en RAM (HISTORIQUE_CAPACITE enregistrements de 12 octets,
+soit un peu plus de 6 min à 100 ms). Le maître récupère une plage de temps
+en une seule requête au lieu de milliers de requêtes 0x1A4.
+
+Requête (ID base + 0xD, 0x1AD pour le nœud 0), valeurs LSB en premier :
+    4 octets : durée en ms, pour les enregistrements les plus récents
+    8 octets : début et fin en ms (horloge millis() du nœud, bornes incluses)
+
+Réponse (ID base + 0xE), segmentée à la manière d'ISO-TP :
+    Première trame : octet #0 = 0x10, octets #1-#2 nombre d'enregistrements,
+                     octets #3-#6 horodatage du premier, octet #7 = 0
+    Trames suivantes : octet #0 = 0x20 + numéro de séquence (1 à 15, puis 0),
+                       octets #1-#7 : 7 octets du flux d'enregistrements
+                       (la dernière trame est complétée par des 0)
+    Flux : 10 octets par enregistrement, écart en ms avec le précédent
+           (2 octets, 0 pour le premier, saturé à 0xFFFF) suivi des 8 octets
+           du format compact ; une donnée sans capteur disponible au moment
+           de l'enregistrement a tous les bits de son champ à 1
+
+Le transfert est envoyé en arrière-plan, au plus HISTORIQUE_TRAMES_PAR_MS
+trames par milliseconde, pour laisser le bus aux autres nœuds. Une nouvelle
+requête remplace le transfert en cours. Si un enregistrement est écrasé par
+le tampon circulaire avant d'être envoyé, le transfert s'arrête : le maître
+reçoit moins d'enregistrements qu'annoncé.
+*/
+
+#ifndef HISTORIQUE_H
+#define HISTORIQUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Nombre d'enregistrements conservés (puissance de 2) et période d'ajout (ms)
+#define HISTORIQUE_CAPACITE 4096
+#define HISTORIQUE_PERIODE_MS 100
+
+// Débit maximal du transfert
+#define HISTORIQUE_TRAMES_PAR_MS 2
+
+// Codes de segmentation (quartet de poids fort de l'octet #0)
+#define HISTORIQUE_PREMIERE_TRAME 0x10
+#define HISTORIQUE_TRAME_SUIVANTE 0x20
+
+/*
+ * Fonction : historique_ajouter
+ * But : Ajoute un enregistrement des mesures courantes
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void historique_ajouter(uint32_t maintenant);
+
+/*
+ * Fonction : historique_demander
+ * But : Prépare le transfert de la plage demandée
+ * Paramètres :
+ *    - donnees : champ de données de la requête
+ *    - longueur : 4 ou 8 octets (sinon la requête est ignorée)
+ *    - maintenant : temps courant en ms (millis())
+ */
+void historique_demander(const uint8_t *donnees, size_t longueur, uint32_t maintenant);
+
+// Indique si des trames du transfert restent à envoyer
+bool historique_en_cours();
+
+/*
+ * Fonction : historique_trame
+ * But : Prépare la prochaine trame du transfert sans l'avancer
+ * Paramètres :
+ *    - donnees : tableau de 8 octets
+ * Retour :
+ *    - false si le transfert est terminé ou interrompu
+ */
+bool historique_trame(uint8_t donnees[8]);
+
+/*
+ * Fonction : historique_avancer
+ * But : Passe à la trame suivante une fois la précédente acceptée par la file d'émission
+ */
+void historique_avancer();
+
+#endif
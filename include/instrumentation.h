@@ -0,0 +1,101 @@
+/*
+Instrumentation du chemin critique en cycles (DWT->CYCCNT)
+
+Chaque étape (réception CAN, transactions I2C de chaque capteur, encodage,
+mise en file d'émission, passage complet dans loop()) accumule en RAM le minimum, le
+maximum, la somme et le nombre de ses mesures. Une requête sur l'ID 0x1A7
+renvoie ces statistiques sur l'ID 0x1A8, deux trames par étape :
+
+    Trame A : octet #0 étape, octet #1 = 0, octets #2-#4 min, octets #5-#7 max
+    Trame B : octet #0 étape, octet #1 = 1, octets #2-#4 moyenne, octets #5-#7 nombre
+
+Suivent deux trames par tâche de l'ordonnanceur (voir ordonnanceur.h),
+une fois toutes les étapes envoyées :
+
+    Trame C : octet #0 = 0x80 + tâche, octet #1 = 2, octets #2-#4 échéances
+              manquées, octets #5-#7 nombre d'exécutions
+
+Viennent enfin les trames de statistiques (0xC0 et suivantes, voir
+statistiques.h).
+
+Les valeurs sont en cycles (180 par µs), sur 24 bits LSB en premier et
+saturées à 0xFFFFFF. Requête sur 0x1A7 : octet #0 = 0x00 (ou trame vide)
+pour lire, 0x01 pour remettre les statistiques à zéro, 0x02 pour ne lire
+que les compteurs de charge.
+*/
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <stdint.h>
+#include "cycles.h"
+
+// Étapes instrumentées
+enum PointMesure
+{
+    POINT_BOUCLE,      // passage complet dans loop()
+    POINT_CAN_RX,      // lecture d'une trame dans le tampon de réception
+    POINT_ENCODAGE,    // encodage des données demandées
+    POINT_CAN_TX,      // mise en file d'une trame à émettre (voir can_tx.h)
+    POINT_I2C_ADS7828, // transaction I2C de l'ADS7828 (gaz)
+    POINT_I2C_BME280,  // transaction I2C du BME280
+    POINT_I2C_SCD41,   // transaction I2C du SCD41
+    POINT_SOMMEIL,     // durée d'un sommeil WFI (voir sommeil.h)
+    POINT_REVEIL,      // début de l'interruption CAN jusqu'à la reprise de loop()
+    NB_POINTS
+};
+
+// Codes de la requête de diagnostic
+#define DIAG_LIRE 0x00
+#define DIAG_REMETTRE_A_ZERO 0x01
+
+// Nombre de trames des étapes dans la réponse de diagnostic
+#define DIAG_NB_TRAMES (2 * NB_POINTS)
+
+// Étiquette des trames de compteurs des tâches
+#define DIAG_ETIQUETTE_TACHE 0x80
+
+/*
+ * Fonction : instrumentation_ajouter
+ * But : Ajoute une mesure aux statistiques d'une étape
+ */
+void instrumentation_ajouter(PointMesure point, uint32_t cycles);
+
+/*
+ * Fonction : instrumentation_remettre_a_zero
+ * But : Efface les statistiques de toutes les étapes
+ */
+void instrumentation_remettre_a_zero();
+
+/*
+ * Fonction : instrumentation_trame
+ * But : Prépare une trame de la réponse de diagnostic
+ * Paramètres :
+ *    - numero : numéro de la trame (0 à DIAG_NB_TRAMES - 1)
+ *    - donnees : tableau de 8 octets
+ */
+void instrumentation_trame(uint8_t numero, uint8_t donnees[8]);
+
+/*
+ * Fonction : instrumentation_trame_compteurs
+ * But : Prépare une trame de diagnostic portant deux compteurs
+ *       (octet #0 étiquette, octet #1 = 2, octets #2-#4 et #5-#7 compteurs)
+ */
+void instrumentation_trame_compteurs(uint8_t etiquette, uint32_t premier, uint32_t second, uint8_t donnees[8]);
+
+/*
+ * Classe : MesureCycles
+ * But : Mesure la durée de la portée où l'objet est déclaré
+ */
+class MesureCycles
+{
+public:
+    explicit MesureCycles(PointMesure point) : point(point), debut(cycles_lire()) {}
+    ~MesureCycles() { instrumentation_ajouter(point, cycles_lire() - debut); }
+
+private:
+    PointMesure point;
+    uint32_t debut;
+};
+
+#endif
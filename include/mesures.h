@@ -0,0 +1,39 @@
+/*
+Copie en cache des mesures de tous les capteurs
+
+Cette structure ne dépend d'aucune librairie matérielle : elle est remplie
+par l'acquisition et lue par l'encodage des trames CAN.
+*/
+
+#ifndef MESURES_H
+#define MESURES_H
+
+#include <stdint.h>
+
+// Données disponibles, dans l'ordre des octets du masque de requête
+enum Donnee
+{
+    DONNEE_METHANE,     // Octet #0
+    DONNEE_CO2,         // Octet #1
+    DONNEE_CO,          // Octet #2
+    DONNEE_TEMPERATURE, // Octet #3
+    DONNEE_HUMIDITE,    // Octet #4
+    DONNEE_PRESSION,    // Octet #5
+    NB_DONNEES
+};
+
+/*
+ * Structure : Mesures
+ * But : Dernières valeurs converties de chaque donnée, prêtes à être encodées
+ */
+struct Mesures
+{
+    uint16_t methane_ppm; // Octet #0
+    uint16_t co2_ppm;     // Octet #1
+    uint16_t co_ppm;      // Octet #2
+    float temperature_c;  // Octet #3 (fusion BME280 et SCD41)
+    float humidite_pct;   // Octet #4 (fusion BME280 et SCD41)
+    float pression_kpa;   // Octet #5
+};
+
+#endif
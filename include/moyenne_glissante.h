@@ -0,0 +1,77 @@
+/*
+Moyenne glissante à somme incrémentale
+
+Les N derniers échantillons sont conservés dans un tampon circulaire et
+leur somme est mise à jour à chaque ajout (on retire le plus ancien, on
+ajoute le nouveau) : le coût est O(1) par échantillon, sans jamais
+ressommer le tampon.
+
+La somme permet aussi le suréchantillonnage avec décimation : la somme de
+4^k échantillons décalée de k bits vers la droite donne k bits de
+résolution supplémentaires (si le bruit dépasse environ 1 LSB).
+*/
+
+#ifndef MOYENNE_GLISSANTE_H
+#define MOYENNE_GLISSANTE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+template <size_t N>
+class MoyenneGlissante
+{
+    static_assert(N != 0 && (N & (N - 1)) == 0, "N doit etre une puissance de 2");
+
+public:
+    /*
+     * Fonction : ajouter
+     * But : Ajoute un échantillon et retire le plus ancien ; le premier
+     *       échantillon remplit tout le tampon pour éviter une montée lente
+     */
+    void ajouter(uint16_t echantillon)
+    {
+        if (!initialise)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                echantillons[i] = echantillon;
+            }
+            total = static_cast<uint32_t>(echantillon) * N;
+            initialise = true;
+            return;
+        }
+
+        total -= echantillons[index];
+        echantillons[index] = echantillon;
+        total += echantillon;
+        index = (index + 1) & (N - 1);
+    }
+
+    // Somme des N derniers échantillons
+    uint32_t somme() const { return total; }
+
+    // Moyenne arrondie à la résolution d'origine
+    uint16_t moyenne() const { return static_cast<uint16_t>((total + N / 2) >> log2_n()); }
+
+    /*
+     * Fonction : decimer
+     * But : Valeur suréchantillonnée avec bits_supplementaires() bits de plus
+     *       que les échantillons d'origine
+     */
+    uint32_t decimer() const { return total >> (log2_n() - bits_supplementaires()); }
+
+    // Nombre de bits gagnés par le suréchantillonnage (N = 4^k donne k bits)
+    static constexpr uint8_t bits_supplementaires() { return log2_n() / 2; }
+
+    bool pret() const { return initialise; }
+
+private:
+    static constexpr uint8_t log2_n(size_t n = N) { return n <= 1 ? 0 : 1 + log2_n(n / 2); }
+
+    uint16_t echantillons[N] = {0};
+    uint32_t total = 0;
+    size_t index = 0;
+    bool initialise = false;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+Ordonnanceur coopératif à priorités fixes
+
+Chaque tâche a sa période (ou, si la période est nulle, une condition qui
+la rend prête, par exemple une trame reçue) et un délai maximal entre le
+moment où elle devient prête et son exécution. Un appel à
+ordonnanceur_executer() exécute une seule tâche : la première prête dans
+l'ordre du tableau, qui est l'ordre de priorité. Après chaque tâche, la
+recherche reprend depuis la plus prioritaire : la latence de la tâche CAN
+est bornée par la durée de la plus longue tâche, et non par la somme des
+lectures de capteurs échues au même moment.
+
+Les tâches ne doivent jamais bloquer : une lecture de capteur soumet ses
+transactions à la file I2C, qui est elle-même une tâche.
+*/
+
+#ifndef ORDONNANCEUR_H
+#define ORDONNANCEUR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Structure : Tache
+ * But : Description et compteurs d'une tâche
+ */
+struct Tache
+{
+    void (*executer)(uint32_t maintenant);
+    bool (*prete)();     // tâche événementielle (periode_ms = 0) : prête si vrai
+    uint32_t periode_ms; // 0 : tâche événementielle
+    uint32_t delai_ms;   // retard toléré avant de compter une échéance manquée
+
+    uint32_t echeance = 0;   // tâche périodique : prochaine activation
+                             // tâche événementielle : instant où elle a été vue prête
+    bool en_attente = false; // tâche événementielle vue prête, pas encore exécutée
+    uint32_t executions = 0;
+    uint32_t manquees = 0;   // exécutions commencées plus de delai_ms après l'activation
+};
+
+/*
+ * Fonction : ordonnanceur_init
+ * But : Planifie la première activation de chaque tâche périodique
+ * Paramètres :
+ *    - taches : tâches par ordre de priorité décroissante
+ *    - nb : nombre de tâches
+ *    - maintenant : temps courant en ms (millis())
+ */
+void ordonnanceur_init(Tache *const *taches, size_t nb, uint32_t maintenant);
+
+/*
+ * Fonction : ordonnanceur_executer
+ * But : Exécute la tâche prête la plus prioritaire
+ * Paramètres :
+ *    - taches : tâches par ordre de priorité décroissante
+ *    - nb : nombre de tâches
+ *    - maintenant : temps courant en ms (millis())
+ * Retour :
+ *    - false si aucune tâche n'était prête
+ */
+bool ordonnanceur_executer(Tache *const *taches, size_t nb, uint32_t maintenant);
+
+/*
+ * Fonction : ordonnanceur_avancer
+ * But : Rend une tâche périodique prête dès maintenant
+ */
+void ordonnanceur_avancer(Tache &tache, uint32_t maintenant);
+
+/*
+ * Fonction : ordonnanceur_remettre_a_zero
+ * But : Efface les compteurs d'exécution et d'échéances manquées
+ */
+void ordonnanceur_remettre_a_zero(Tache *const *taches, size_t nb);
+
+#endif
@@ -0,0 +1,123 @@
+/*
+Protocole CAN du projet capteur
+
+Identifiants des trames et encodage des données demandées par le masque
+(un octet 0x11 par donnée désirée, dans l'ordre des octets #0 à #5).
+Ce module ne dépend d'aucune librairie matérielle.
+*/
+
+#ifndef PROTOCOLE_H
+#define PROTOCOLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "donnees.h"
+
+// Base des identifiants : le nœud n (0 à CAN_NB_NOEUDS - 1, voir adressage.h)
+// occupe le bloc de 16 ID aligné CAN_ID_BASE + 0x10 * n
+#ifndef CAN_ID_BASE
+#define CAN_ID_BASE 0x1A0
+#endif
+#define CAN_TAILLE_BLOC 0x10
+#define CAN_NB_NOEUDS 4
+
+// Masque du filtre d'acceptation : seules les trames du bloc du nœud sont reçues
+#define CAN_MASQUE_BLOC 0x7F0
+
+static_assert((CAN_ID_BASE & ~CAN_MASQUE_BLOC) == 0, "CAN_ID_BASE doit etre aligne sur 16");
+static_assert(CAN_ID_BASE >= CAN_TAILLE_BLOC, "CAN_ID_GROUPE doit preceder le bloc du noeud 0");
+static_assert(CAN_ID_BASE + CAN_TAILLE_BLOC * CAN_NB_NOEUDS <= 0x800, "Les blocs doivent etre des identifiants standards");
+
+// Requête « échantillonner tout », reçue par tous les nœuds (0x19F avec la base par défaut)
+#define CAN_ID_GROUPE (CAN_ID_BASE - 1)
+
+// Position de chaque identifiant dans le bloc du nœud (0x1A3 à 0x1AF pour le nœud 0)
+#define CAN_DECALAGE_CONFIG_DIFFUSION 0x3 // Configuration du mode diffusion
+#define CAN_DECALAGE_REQUETE 0x4          // Requête de données
+#define CAN_DECALAGE_REPONSE_1 0x5        // Méthane, CO2, CO, température, humidité
+#define CAN_DECALAGE_REPONSE_2 0x6        // Pression atmosphérique
+#define CAN_DECALAGE_DIAGNOSTIC 0x7       // Requête de diagnostic (voir instrumentation.h)
+#define CAN_DECALAGE_DIAGNOSTIC_REPONSE 0x8
+#define CAN_DECALAGE_COMMANDE 0x9         // Commande de configuration (voir commandes.h)
+#define CAN_DECALAGE_COMMANDE_REPONSE 0xA // Réponse à une commande
+#define CAN_DECALAGE_REPONSE_COMPACTE 0xB // Six données dans une seule trame (format compact)
+#define CAN_DECALAGE_ETAT 0xC             // Disponibilité des capteurs (voir capteurs.h)
+#define CAN_DECALAGE_HISTORIQUE 0xD       // Requête d'historique (voir historique.h)
+#define CAN_DECALAGE_HISTORIQUE_REPONSE 0xE
+#define CAN_DECALAGE_SANTE 0xF            // Cause du démarrage et récupérations I2C (voir sante.h)
+
+// Valeur de l'octet du masque indiquant qu'une donnée est demandée
+#define DONNEE_DEMANDEE 0x11
+
+// Taille des données encodées dans les trames 0x1A5 puis 0x1A6 (9 octets, voir donnees.h)
+#define TAILLE_DONNEES (position_donnee(NB_DONNEES))
+
+// Formats de réponse (choisis par la commande 0x03, voir commandes.h)
+enum FormatReponse
+{
+    FORMAT_STANDARD, // trames 0x1A5/0x1A6, données demandées par le masque
+    FORMAT_COMPACT,  // trame 0x1AB, toutes les données
+};
+
+/*
+Format compact : les six données et un compteur de séquence dans une seule
+trame de 8 octets. Les 64 bits sont lus comme un entier LSB en premier.
+Un champ dont tous les bits sont à 1 signale une donnée indisponible
+(aucun capteur ne la fournit, comme 0xFF dans 0x1A5/0x1A6) ; les valeurs
+mesurées sont saturées à la valeur précédente.
+
+    Bits  0 à  2 : séquence (0 à 7, incrémentée à chaque trame)
+    Bits  3 à 11 : méthane, pas de 20 ppm (0 à 10200 ppm)
+    Bits 12 à 21 : CO2, pas de 10 ppm (0 à 10220 ppm)
+    Bits 22 à 31 : CO, pas de 2 ppm (0 à 2044 ppm)
+    Bits 32 à 41 : température, pas de 0,1 °C à partir de -40,0 °C (-40,0 à 62,2 °C)
+    Bits 42 à 51 : humidité, pas de 0,1 % (0 à 102,2 %)
+    Bits 52 à 63 : pression, pas de 0,01 kPa à partir de 70,00 kPa (70,00 à 110,94 kPa)
+*/
+
+/*
+ * Fonction : encoder_compact
+ * But : Encode toutes les données au format compact
+ * Paramètres :
+ *    - mesures : valeurs à encoder
+ *    - disponibles : bit i à 1 si la donnée i est disponible (sinon champ à 1)
+ *    - sequence : compteur de séquence (seuls les 3 bits de poids faible sont gardés)
+ *    - donnees : tableau de 8 octets
+ */
+void encoder_compact(const Mesures &mesures, uint8_t disponibles, uint8_t sequence, uint8_t donnees[8]);
+
+/*
+ * Fonction : encoder_donnee
+ * But : Encode une seule donnée à sa position dans les trames 0x1A5/0x1A6
+ * Paramètres :
+ *    - mesures : valeurs à encoder
+ *    - donnee : donnée à encoder
+ *    - donnees : tableau de TAILLE_DONNEES octets
+ */
+void encoder_donnee(const Mesures &mesures, Donnee donnee, uint8_t donnees[TAILLE_DONNEES]);
+
+/*
+ * Fonction : decoder_masque
+ * But : Réduit le masque d'une requête à un bit par donnée demandée
+ * Paramètres :
+ *    - masque : un octet par donnée (DONNEE_DEMANDEE si désirée)
+ *    - longueur : nombre d'octets valides dans le masque
+ * Retour :
+ *    - bit i à 1 si la donnée i est demandée
+ */
+uint8_t decoder_masque(const uint8_t *masque, size_t longueur);
+
+/*
+ * Fonction : encoder_donnees
+ * But : Encode les données demandées par le masque ; les données non demandées
+ *       sont remplacées par 0xFF
+ * Paramètres :
+ *    - mesures : valeurs à encoder
+ *    - masque : un octet par donnée (DONNEE_DEMANDEE si désirée)
+ *    - longueur : nombre d'octets valides dans le masque
+ *    - donnees : tableau de TAILLE_DONNEES octets (0x1A5 puis 0x1A6)
+ */
+void encoder_donnees(const Mesures &mesures, const uint8_t *masque, size_t longueur,
+                     uint8_t donnees[TAILLE_DONNEES]);
+
+#endif
@@ -0,0 +1,78 @@
+/*
+Surveillance de la carte par le chien de garde indépendant (IWDG)
+
+L'IWDG, cadencé par le LSI (32 kHz) indépendamment de l'horloge système,
+redémarre la carte s'il n'est pas rechargé pendant SANTE_IWDG_DELAI_MS.
+sante_rafraichir() est appelée à chaque passage dans loop() mais ne
+recharge le chien de garde que si le service CAN suit : une trame reçue
+qui attend depuis plus de SANTE_DELAI_CAN_MS sans que servir_can() ne
+s'exécute laisse expirer le délai. Une boucle bloquée (ex. dans la
+librairie Wire) redémarre donc la carte au lieu de la rendre muette.
+
+Le délai couvre l'opération bloquante connue : effacement d'un secteur
+de stockage (2 s au plus, un seul par écriture, voir stockage.h).
+
+Trame de santé (ID base + 0xF, 0x1AF pour le nœud 0), envoyée au démarrage
+et à chaque nouvelle récupération du bus I2C (voir bus_i2c.h) :
+    Octet #0 : cause du dernier démarrage (bit 0 chien de garde, bit 1
+               logiciel, bit 2 broche NRST, bit 3 mise sous tension ou
+               baisse d'alimentation)
+    Octets #1-#2 : récupérations du bus I2C (LSB en premier, saturé)
+    Octets #3-#4 : transactions I2C en erreur de bus ou trop longues
+    Octets #5-#6 : redémarrages par le chien de garde vus depuis la mise
+                   sous tension (registre de sauvegarde RTC)
+*/
+
+#ifndef SANTE_H
+#define SANTE_H
+
+#include <stdint.h>
+
+// Délai du chien de garde (ms, 8000 au plus avec le prédiviseur de 64)
+#define SANTE_IWDG_DELAI_MS 4000
+
+// Attente maximale d'une trame reçue avant de cesser de recharger le chien de garde (ms)
+#define SANTE_DELAI_CAN_MS 500
+
+// Taille de la trame de santé
+#define SANTE_TAILLE_TRAME 7
+
+// Bits de la cause du dernier démarrage
+#define SANTE_DEMARRAGE_CHIEN_DE_GARDE 0x01
+#define SANTE_DEMARRAGE_LOGICIEL 0x02
+#define SANTE_DEMARRAGE_BROCHE 0x04
+#define SANTE_DEMARRAGE_ALIMENTATION 0x08
+
+/*
+ * Fonction : sante_init
+ * But : Relève la cause du démarrage et démarre le chien de garde
+ *       (l'IWDG ne peut plus être arrêté ensuite)
+ */
+void sante_init();
+
+/*
+ * Fonction : sante_service_can
+ * But : Signale que le service CAN vient de s'exécuter
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void sante_service_can(uint32_t maintenant);
+
+/*
+ * Fonction : sante_rafraichir
+ * But : Recharge le chien de garde si le service CAN suit les trames reçues
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ */
+void sante_rafraichir(uint32_t maintenant);
+
+// Indique si la trame de santé doit être envoyée (démarrage ou nouvelle récupération)
+bool sante_a_publier();
+
+/*
+ * Fonction : sante_trame
+ * But : Remplit la trame de santé (SANTE_TAILLE_TRAME octets)
+ */
+void sante_trame(uint8_t donnees[8]);
+
+#endif
@@ -0,0 +1,75 @@
+/*
+Pilote SCD41 non bloquant
+
+Le SCD41 ne produit une nouvelle mesure que toutes les 5 s (30 s en mode
+basse consommation). Au lieu d'appeler getCO2() à chaque requête, ce
+pilote vérifie périodiquement l'état « donnée prête » et ne lit les trois
+valeurs (CO2, température, humidité) qu'en une seule transaction, et
+seulement lorsqu'une nouvelle mesure existe.
+
+Chaque commande Sensirion exige environ 1 ms entre l'écriture et la
+lecture : plutôt que d'attendre avec delay(), la machine à états soumet la
+commande à la file I2C (voir bus_i2c.h), puis soumet la lecture de la
+réponse une fois le délai écoulé.
+
+Le démarrage passe par la même machine à états : arrêt d'une mesure en
+cours (500 ms), réinitialisation (30 ms), lecture du numéro de série pour
+vérifier le capteur, puis démarrage de la mesure périodique. Aucune étape
+ne bloque loop() ; la librairie SparkFun, dont begin() attend ~1 s avec
+delay(), n'est plus utilisée.
+*/
+
+#ifndef SCD41_H
+#define SCD41_H
+
+#include <stdint.h>
+
+// Adresse I2C du capteur
+#define SCD41_ADRESSE 0x62
+
+// Intervalle entre deux vérifications de l'état « donnée prête » (ms)
+#define SCD41_PERIODE_VERIFICATION_MS 500
+
+// Mode basse consommation par défaut (une mesure toutes les 30 s)
+#ifndef SCD41_BASSE_CONSOMMATION
+#define SCD41_BASSE_CONSOMMATION 0
+#endif
+
+/*
+ * Structure : Scd41Mesure
+ * But : Dernière mesure complète lue sur le SCD41
+ */
+struct Scd41Mesure
+{
+    uint16_t co2_ppm;
+    float temperature_c;
+    float humidite_pct;
+    uint32_t horodatage_ms; // millis() au moment de la lecture
+};
+
+/*
+ * Fonction : scd41_demarrer
+ * But : Lance la séquence de démarrage en mesure périodique normale ou basse
+ *       consommation (étapes exécutées ensuite par scd41_executer())
+ * Paramètres :
+ *    - basse_consommation : true pour une mesure toutes les 30 s
+ */
+void scd41_demarrer(bool basse_consommation);
+
+// Indique qu'une étape du démarrage a échoué (capteur absent ou réponse invalide)
+bool scd41_en_defaut();
+
+/*
+ * Fonction : scd41_executer
+ * But : Soumet la prochaine étape I2C de la machine à états lorsqu'elle est due
+ * Paramètres :
+ *    - maintenant : temps courant en ms (millis())
+ * Retour :
+ *    - true si une nouvelle mesure a été lue depuis l'appel précédent
+ */
+bool scd41_executer(uint32_t maintenant);
+
+// Dernière mesure lue
+const Scd41Mesure &scd41_mesure();
+
+#endif
@@ -0,0 +1,43 @@
+/*
+Mise en veille du cœur entre deux événements
+
+Lorsqu'aucune tâche de l'ordonnanceur n'est prête (voir ordonnanceur.h),
+le cœur exécute WFI et reste en mode Sleep jusqu'à la prochaine
+interruption : réception CAN1_RX0 ou SysTick (1 ms), qui cadence les
+échéances des tâches. Les périphériques et leurs horloges restent actifs,
+la réponse à une requête n'est donc retardée que par le temps de réveil
+du cœur.
+
+Le mode STOP n'est pas utilisé : le bxCAN n'y est plus cadencé, la trame
+qui réveille le MCU (par l'EXTI de la broche RX) serait perdue, et le
+redémarrage du HSE et de la PLL à chaque échantillon de gaz (10 ms)
+coûterait plus qu'il ne rapporte.
+
+Consommation :
+    Les valeurs typiques du mode Run et du mode Sleep à 180 MHz sont
+    données par la fiche technique du STM32F446 (DS10693, tableaux de
+    consommation en mode Run et Sleep) ; elles n'ont pas été mesurées sur
+    la carte. Pour les mesurer, retirer le cavalier JP6 (IDD) de la
+    Nucleo et brancher un ampèremètre à sa place. Le courant moyen vaut
+    environ I_run * (1 - r) + I_sleep * r, où r est la fraction du temps
+    passée en sommeil, tirée des statistiques de diagnostic.
+
+Banc d'essai (diagnostic 0x1A7, voir instrumentation.h) :
+    POINT_SOMMEIL : durée de chaque sommeil (somme / temps écoulé = r)
+    POINT_REVEIL : cycles entre le début de l'interruption de réception et
+                   la reprise de loop() après WFI, soit le coût du réveil
+                   par une trame CAN vu par le logiciel
+*/
+
+#ifndef SOMMEIL_H
+#define SOMMEIL_H
+
+/*
+ * Fonction : sommeil_attendre
+ * But : Met le cœur en veille jusqu'à la prochaine interruption, sauf si une
+ *       trame CAN est déjà en attente (vérifié interruptions masquées, pour ne
+ *       pas s'endormir juste après une réception)
+ */
+void sommeil_attendre();
+
+#endif
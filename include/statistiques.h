@@ -0,0 +1,81 @@
+/*
+Statistiques d'exécution et de charge du bus
+
+Compteurs cumulés depuis le démarrage, pour savoir si la carte approche de
+sa limite sous la charge de la flotte. Ils complètent les mesures en cycles
+(voir instrumentation.h) : une requête sur l'ID 0x1A7 avec l'octet #0 =
+0x02 renvoie sur l'ID 0x1A8 STATISTIQUES_NB_TRAMES trames de compteurs,
+au même format que les trames des tâches :
+
+    Octet #0 : 0xC0 + numéro de la trame, octet #1 = 2,
+    octets #2-#4 premier compteur, octets #5-#7 second compteur
+
+    0xC0 Trames reçues (filtre matériel passé) / trames ignorées (ID inconnu)
+    0xC1 Requêtes 0x1A4 et de groupe reçues / requêtes 0x1A4 servies plus de
+         STATISTIQUES_RETARD_MS après leur réception
+    0xC2 Trames émises / émissions échouées (voir can_tx.h)
+    0xC3 Trames perdues, file d'émission pleine / boîtes d'émission pleines
+    0xC4 Trames perdues en réception, tampon plein / FIFO matérielle pleine
+    0xC5 Erreurs du bus I2C (erreur de bus, d'arbitrage ou délai dépassé) /
+         récupérations du bus (voir bus_i2c.h)
+    0xC6 Âge de la dernière mesure de l'ADS7828 / du BME280 (ms)
+    0xC7 Âge de la dernière mesure du SCD41 (ms) / passages dans loop() par seconde
+    0xC8 Transactions I2C sans acquittement (esclave absent ou lecture
+         incomplète, non comptées dans 0xC5) / transactions I2C exécutées
+
+Les compteurs sont envoyés modulo 2^24 : l'hôte calcule les débits par
+différence entre deux lectures. Les âges et le nombre de passages sont
+saturés à 0xFFFFFF (capteur indisponible). Les trames rejetées par le
+filtre matériel ne sont pas visibles par le logiciel et ne sont pas
+comptées. Une remise à zéro du diagnostic (0x01) ne touche pas ces
+compteurs.
+*/
+
+#ifndef STATISTIQUES_H
+#define STATISTIQUES_H
+
+#include <stdint.h>
+
+// Code de la requête de diagnostic qui ne renvoie que les statistiques
+#define DIAG_STATISTIQUES 0x02
+
+// Étiquette de la première trame de statistiques
+#define DIAG_ETIQUETTE_STATISTIQUES 0xC0
+
+#define STATISTIQUES_NB_TRAMES 9
+
+// Délai au-delà duquel la réponse à une requête 0x1A4 est comptée en retard (ms)
+#define STATISTIQUES_RETARD_MS 2
+
+/*
+ * Fonction : statistiques_requete
+ * But : Compte une requête de données reçue
+ * Paramètres :
+ *    - reception_ms : horodatage de la trame (16 bits de poids faible de millis())
+ *    - maintenant : temps courant en ms (millis()), après la mise en file de la réponse
+ */
+void statistiques_requete(uint16_t reception_ms, uint32_t maintenant);
+
+// Compte une requête de groupe, servie plus tard dans le créneau du nœud
+void statistiques_requete_groupe();
+
+// Compte une trame reçue dont l'identifiant n'est traité par aucun service
+void statistiques_ignoree();
+
+/*
+ * Fonction : statistiques_boucle
+ * But : Compte un passage dans loop() et met à jour le débit par seconde
+ */
+void statistiques_boucle(uint32_t maintenant);
+
+/*
+ * Fonction : statistiques_trame
+ * But : Prépare une trame de statistiques
+ * Paramètres :
+ *    - numero : numéro de la trame (0 à STATISTIQUES_NB_TRAMES - 1)
+ *    - maintenant : temps courant en ms (millis()), pour l'âge des mesures
+ *    - donnees : tableau de 8 octets
+ */
+void statistiques_trame(uint8_t numero, uint32_t maintenant, uint8_t donnees[8]);
+
+#endif
@@ -0,0 +1,60 @@
+/*
+Stockage persistant en mémoire flash
+
+Les deux derniers secteurs de la flash (secteurs 6 et 7, 128 Ko chacun à
+partir de 0x08040000) sont utilisés à tour de rôle comme journal : chaque
+écriture ajoute un nouvel enregistrement à la suite du précédent, protégé
+par un CRC-32. Au démarrage, le dernier enregistrement valide du secteur
+courant est retenu. Aucun effacement n'a lieu tant que le secteur n'est
+pas plein, ce qui répartit l'usure et évite un effacement (~1 s, pendant
+lequel le CPU est bloqué) à chaque modification.
+
+Lorsque le secteur courant est plein, le nouvel enregistrement est écrit au
+début de l'autre secteur, marqué d'une génération incrémentée ; l'ancien
+secteur n'est effacé qu'après relecture du nouvel enregistrement. Une
+coupure d'alimentation à n'importe quel moment laisse donc toujours un
+enregistrement valide : le secteur courant est celui de génération la plus
+récente qui en contient un.
+
+Un journal d'une version à un seul secteur (secteur 7, sans marque) est
+relu comme la génération 0.
+*/
+
+#ifndef STOCKAGE_H
+#define STOCKAGE_H
+
+#include <stdint.h>
+
+// Secteurs réservés, consécutifs (le programme ne doit pas dépasser 0x08040000)
+#define STOCKAGE_ADRESSE 0x08040000UL
+#define STOCKAGE_TAILLE (128UL * 1024UL) // taille d'un secteur
+#define STOCKAGE_NB_SECTEURS 2
+
+// Taille maximale d'un enregistrement (octets)
+#define STOCKAGE_TAILLE_MAX 256
+
+/*
+ * Fonction : stockage_lire
+ * But : Copie le dernier enregistrement valide
+ * Paramètres :
+ *    - donnees : destination
+ *    - taille : taille attendue de l'enregistrement
+ * Retour :
+ *    - false si aucun enregistrement valide de cette taille n'existe
+ */
+bool stockage_lire(void *donnees, uint16_t taille);
+
+/*
+ * Fonction : stockage_ecrire
+ * But : Ajoute un enregistrement au journal (passe à l'autre secteur et
+ *       efface l'ancien si le secteur courant est plein)
+ * Paramètres :
+ *    - donnees : contenu à sauvegarder
+ *    - taille : nombre d'octets (au plus STOCKAGE_TAILLE_MAX)
+ * Retour :
+ *    - false si l'écriture ou la relecture a échoué (le dernier
+ *      enregistrement valide reste lisible)
+ */
+bool stockage_ecrire(const void *donnees, uint16_t taille);
+
+#endif
@@ -0,0 +1,25 @@
+/*
+Table des vecteurs d'interruption en RAM
+
+Certaines interruptions sont déjà définies par les librairies (ex. STM32_CAN
+définit ses propres gestionnaires pour CAN1). Pour les remplacer sans
+modifier les librairies, la table des vecteurs est copiée en RAM et le
+registre SCB->VTOR est redirigé vers cette copie.
+*/
+
+#ifndef VECTEURS_H
+#define VECTEURS_H
+
+#include <Arduino.h>
+
+/*
+ * Fonction : vecteurs_remplacer
+ * But : Remplace le gestionnaire d'une interruption périphérique
+ *       (la table est copiée en RAM au premier appel)
+ * Paramètres :
+ *    - irq : numéro de l'interruption (ex. CAN1_RX0_IRQn)
+ *    - gestionnaire : nouvelle fonction appelée par l'interruption
+ */
+void vecteurs_remplacer(IRQn_Type irq, void (*gestionnaire)(void));
+
+#endif
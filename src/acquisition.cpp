@@ -0,0 +1,210 @@
+#include "acquisition.h"
+
+#include "adc_interne.h"
+#include "ads7828.h"
+#include "bme280_rafale.h"
+#include "bus_i2c.h"
+#include "alarmes.h"
+#include "cache_reponses.h"
+#include "capteurs.h"
+#include "conversion_gaz.h"
+#include "fusion.h"
+#include "moyenne_glissante.h"
+#include "scd41.h"
+
+// Sources de la température et de l'humidité (voir fusion.h)
+enum SourceFusion
+{
+    FUSION_BME280, // référence : précise et rafraîchie toutes les 500 ms
+    FUSION_SCD41,  // une mesure toutes les 5 s, biaisée par l'auto-échauffement
+    NB_SOURCES_FUSION
+};
+
+// Écarts types de mesure : 0,5 °C / 1 % (BME280), 1 °C / 2 % (SCD41) ;
+// dérive admise de 0,1 °C et 0,5 % par racine de seconde
+static Fusion<NB_SOURCES_FUSION> fusion_temperature({{0.25f, 1.0f}, 0.01f, 0.05f, FUSION_REFERENCE_MS});
+static Fusion<NB_SOURCES_FUSION> fusion_humidite({{1.0f, 4.0f}, 0.25f, 0.05f, FUSION_REFERENCE_MS});
+
+// Profil du BME280 et écriture de ses registres en attente
+static ProfilBme280 profil_bme280 = PROFIL_BME280_DEFAUT;
+static bool profil_a_ecrire = false;
+
+// Moyenne glissante et suréchantillonnage de chaque canal de gaz
+static MoyenneGlissante<ECHANTILLONS_GAZ> filtres_gaz[NB_GAZ];
+
+static Mesures mesures = {};
+
+// Instant (millis()) de la dernière mise à jour de chaque donnée
+static uint32_t horodatages[NB_DONNEES] = {0};
+
+/*
+ * Fonction : mise_a_jour
+ * But : Horodate une donnée qui vient de changer et vérifie ses seuils d'alarme
+ */
+static void mise_a_jour(Donnee donnee, uint32_t horodatage)
+{
+    horodatages[donnee] = horodatage;
+    alarmes_evaluer(donnee, mesures_valeur(mesures, donnee));
+}
+
+/*
+ * Fonction : fusionner
+ * But : Intègre un nouvel échantillon de température et d'humidité d'une
+ *       source ; la donnée servie est l'estimation fusionnée
+ */
+static void fusionner(SourceFusion source, float temperature_c, float humidite_pct, uint32_t instant)
+{
+    fusion_temperature.ajouter(source, temperature_c, instant);
+    fusion_humidite.ajouter(source, humidite_pct, instant);
+
+    mesures.temperature_c = fusion_temperature.valeur();
+    mesures.humidite_pct = fusion_humidite.valeur();
+    mise_a_jour(DONNEE_TEMPERATURE, instant);
+    mise_a_jour(DONNEE_HUMIDITE, instant);
+}
+
+static void fin_gaz(uint16_t code, uint32_t capteur)
+{
+    MoyenneGlissante<ECHANTILLONS_GAZ> &filtre = filtres_gaz[capteur];
+    filtre.ajouter(code);
+    capteur_actif(CAPTEUR_ADS7828, millis());
+
+    // Valeur filtrée avec les bits gagnés par suréchantillonnage
+    uint16_t ppm = conversion_ppm_interpolee(static_cast<CapteurGaz>(capteur), filtre.decimer(),
+                                             MoyenneGlissante<ECHANTILLONS_GAZ>::bits_supplementaires());
+    if (capteur == GAZ_METHANE)
+    {
+        mesures.methane_ppm = ppm;
+        mise_a_jour(DONNEE_METHANE, millis());
+    }
+    else
+    {
+        mesures.co_ppm = ppm;
+        mise_a_jour(DONNEE_CO, millis());
+    }
+}
+
+static void lire_gaz(uint32_t)
+{
+    if (!capteur_disponible(CAPTEUR_ADS7828))
+        return;
+
+#ifdef GAZ_ADC_INTERNE
+    // Lecture immédiate du tampon DMA, sans transaction I2C
+    adc_interne_soumettre(ADC_INTERNE_CANAL_SEN_094, fin_gaz, GAZ_METHANE);
+    adc_interne_soumettre(ADC_INTERNE_CANAL_MQ7, fin_gaz, GAZ_CO);
+#else
+    ads7828_soumettre(ADS7828_CANAL_SEN_094, fin_gaz, GAZ_METHANE);
+    ads7828_soumettre(ADS7828_CANAL_MQ7, fin_gaz, GAZ_CO);
+#endif
+}
+
+static void fin_bme280(const Bme280Mesure &bme280)
+{
+    uint32_t maintenant = millis();
+    mesures.pression_kpa = bme280.pression_pa / 1000.0f;
+    mise_a_jour(DONNEE_PRESSION, maintenant);
+    capteur_actif(CAPTEUR_BME280, maintenant);
+    fusionner(FUSION_BME280, bme280.temperature_c, bme280.humidite_pct, maintenant);
+}
+
+static void lire_bme280(uint32_t)
+{
+    if (!capteur_disponible(CAPTEUR_BME280))
+        return;
+
+    // Nouveau profil : les registres passent avant la lecture dans la file I2C
+    if (profil_a_ecrire && bme280_soumettre_profil(capteurs_adresse_bme280(), profil_bme280))
+        profil_a_ecrire = false;
+
+    // Une seule rafale I2C pour la température, l'humidité et la pression
+    bme280_soumettre_rafale(BME280_Sensor, capteurs_adresse_bme280(), fin_bme280);
+}
+
+static void lire_scd41(uint32_t maintenant)
+{
+    if (!capteur_en_service(CAPTEUR_SCD41))
+        return;
+
+    // Le pilote ne lit le capteur que lorsqu'une nouvelle mesure est prête
+    if (scd41_executer(maintenant))
+    {
+        const Scd41Mesure &scd41 = scd41_mesure();
+        capteur_actif(CAPTEUR_SCD41, scd41.horodatage_ms);
+        mesures.co2_ppm = scd41.co2_ppm;
+        mise_a_jour(DONNEE_CO2, scd41.horodatage_ms);
+        fusionner(FUSION_SCD41, scd41.temperature_c, scd41.humidite_pct, scd41.horodatage_ms);
+    }
+}
+
+static void executer_i2c(uint32_t)
+{
+    // Prête à la fin d'une étape du transfert en cours (interruption I2C1)
+    // ou quand une transaction attend dans la file
+    bus_i2c_executer();
+}
+
+// Lectures soumises par les tâches de capteurs et transactions en attente
+static Tache taches[NB_TACHES_ACQUISITION] = {
+    {lire_gaz, nullptr, periode_source(CAPTEUR_ADS7828), DELAI_GAZ_MS},
+    {executer_i2c, bus_i2c_en_attente, 0, DELAI_I2C_MS},
+    {lire_scd41, nullptr, PERIODE_SCD41_ETAPE_MS, DELAI_SCD41_MS},
+    {lire_bme280, nullptr, profils_bme280[PROFIL_BME280_DEFAUT].periode_ms, DELAI_BME280_MS},
+};
+
+Tache &acquisition_tache(TacheAcquisition tache)
+{
+    return taches[tache];
+}
+
+const Mesures &acquisition_mesures()
+{
+    return mesures;
+}
+
+uint32_t acquisition_horodatage(Donnee donnee)
+{
+    return horodatages[donnee];
+}
+
+void acquisition_rafraichir(Donnee donnee, uint32_t maintenant)
+{
+    if (donnee >= NB_DONNEES)
+        return;
+
+    // Tâche qui interroge la source de la donnée
+    switch (table_donnees[donnee].source)
+    {
+    case CAPTEUR_ADS7828:
+        ordonnanceur_avancer(taches[TACHE_GAZ], maintenant);
+        break;
+    case CAPTEUR_BME280:
+        ordonnanceur_avancer(taches[TACHE_BME280], maintenant);
+        break;
+    default:
+        // Le SCD41 produit ses mesures à son propre rythme
+        break;
+    }
+}
+
+void acquisition_choisir_profil_bme280(ProfilBme280 profil)
+{
+    if (profil >= NB_PROFILS_BME280)
+        return;
+
+    profil_bme280 = profil;
+    profil_a_ecrire = true;
+    taches[TACHE_BME280].periode_ms = profils_bme280[profil].periode_ms;
+
+    // Une fenêtre plus courte que les lectures du profil n'apporterait rien
+    for (uint8_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (table_donnees[i].source == CAPTEUR_BME280)
+            cache_modifier_fenetre_minimale(i, profils_bme280[profil].periode_ms);
+    }
+}
+
+ProfilBme280 acquisition_profil_bme280()
+{
+    return profil_bme280;
+}
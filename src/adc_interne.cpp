@@ -0,0 +1,86 @@
+#include "adc_interne.h"
+
+#include <Arduino.h>
+
+// Canaux convertis dans l'ordre de la séquence
+static const uint8_t canaux[] = {ADC_INTERNE_CANAL_MQ7, ADC_INTERNE_CANAL_SEN_094};
+#define NB_CANAUX (sizeof(canaux) / sizeof(canaux[0]))
+
+// Rempli par le DMA : une conversion de chaque canal par tour
+static volatile uint16_t tampon[ADC_INTERNE_TOURS * NB_CANAUX];
+
+// Temps d'échantillonnage le plus long (480 cycles) : impédance de sortie élevée des capteurs
+#define ADC_INTERNE_SMP 7u
+
+bool adc_interne_init()
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;
+    (void)RCC->APB2ENR;
+
+    // Arrêt d'une éventuelle acquisition précédente (réinitialisation par capteurs.h)
+    ADC1->CR2 = 0;
+    DMA2_Stream0->CR = 0;
+    while (DMA2_Stream0->CR & DMA_SxCR_EN)
+    {
+    }
+    DMA2->LIFCR = DMA_LIFCR_CFEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTCIF0;
+
+    for (size_t i = 0; i < NB_CANAUX; i++)
+    {
+        // Broches en mode analogique (PA0..PA7 = canaux 0 à 7)
+        GPIOA->MODER |= 3u << (GPIO_MODER_MODER0_Pos + 2 * canaux[i]);
+    }
+
+    // ADCCLK = PCLK2 / 4 (36 MHz au plus)
+    ADC123_COMMON->CCR = (ADC123_COMMON->CCR & ~ADC_CCR_ADCPRE) | ADC_CCR_ADCPRE_0;
+
+    ADC1->CR1 = ADC_CR1_SCAN;
+    ADC1->SMPR2 = 0;
+    ADC1->SQR3 = 0;
+    for (size_t i = 0; i < NB_CANAUX; i++)
+    {
+        ADC1->SMPR2 |= ADC_INTERNE_SMP << (3 * canaux[i]);
+        ADC1->SQR3 |= static_cast<uint32_t>(canaux[i]) << (5 * i);
+    }
+    ADC1->SQR1 = (NB_CANAUX - 1) << ADC_SQR1_L_Pos;
+    ADC1->SR = 0;
+
+    // Demi-mots de ADC1->DR vers le tampon, en boucle
+    DMA2_Stream0->PAR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&ADC1->DR));
+    DMA2_Stream0->M0AR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(tampon));
+    DMA2_Stream0->NDTR = ADC_INTERNE_TOURS * NB_CANAUX;
+    DMA2_Stream0->CR = (0u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 |
+                       DMA_SxCR_MINC | DMA_SxCR_CIRC;
+    DMA2_Stream0->CR |= DMA_SxCR_EN;
+
+    // DDS : le DMA reste actif après la dernière donnée (mode circulaire)
+    ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_DDS;
+    delayMicroseconds(3); // stabilisation de l'ADC (tSTAB)
+    ADC1->CR2 |= ADC_CR2_SWSTART;
+
+    return (ADC1->CR2 & ADC_CR2_ADON) && (DMA2_Stream0->CR & DMA_SxCR_EN);
+}
+
+bool adc_interne_soumettre(uint8_t canal, void (*fin)(uint16_t code, uint32_t contexte), uint32_t contexte)
+{
+    size_t position = 0;
+    while (position < NB_CANAUX && canaux[position] != canal)
+    {
+        position++;
+    }
+
+    // Une erreur de transfert ou un débordement de l'ADC arrête les conversions
+    if (position == NB_CANAUX || !(DMA2_Stream0->CR & DMA_SxCR_EN) || (ADC1->SR & ADC_SR_OVR))
+        return false;
+
+    // Le DMA écrit pendant la lecture : chaque demi-mot reste une conversion complète
+    uint32_t somme = 0;
+    for (size_t tour = 0; tour < ADC_INTERNE_TOURS; tour++)
+    {
+        somme += tampon[tour * NB_CANAUX + position];
+    }
+
+    fin(static_cast<uint16_t>((somme + ADC_INTERNE_TOURS / 2) / ADC_INTERNE_TOURS), contexte);
+    return true;
+}
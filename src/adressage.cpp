@@ -0,0 +1,67 @@
+#include "adressage.h"
+
+#include <Arduino.h>
+
+static uint8_t noeud = 0;
+static uint16_t base_noeud_0 = CAN_ID_BASE;
+
+// Requête de groupe en attente de son créneau
+static uint8_t masque_groupe[NB_DONNEES] = {0};
+static size_t longueur_groupe = 0;
+static uint32_t reception_us = 0;
+static bool en_attente = false;
+
+void adressage_init(uint16_t base)
+{
+    base_noeud_0 = base;
+
+    pinMode(ADRESSAGE_BROCHE_BIT0, INPUT_PULLUP);
+    pinMode(ADRESSAGE_BROCHE_BIT1, INPUT_PULLUP);
+
+    // Un cavalier à la masse donne un bit à 1 : sans cavalier, nœud 0
+    noeud = static_cast<uint8_t>((digitalRead(ADRESSAGE_BROCHE_BIT0) == LOW ? 1 : 0) |
+                                 (digitalRead(ADRESSAGE_BROCHE_BIT1) == LOW ? 2 : 0));
+}
+
+uint8_t adressage_noeud()
+{
+    return noeud;
+}
+
+uint32_t adressage_base()
+{
+    return base_noeud_0 + CAN_TAILLE_BLOC * noeud;
+}
+
+uint32_t adressage_groupe()
+{
+    return base_noeud_0 - 1u;
+}
+
+void adressage_requete_groupe(const uint8_t *masque, size_t longueur, uint32_t maintenant_us)
+{
+    if (longueur > NB_DONNEES)
+        longueur = NB_DONNEES;
+
+    for (size_t i = 0; i < longueur; i++)
+    {
+        masque_groupe[i] = masque[i];
+    }
+    longueur_groupe = longueur;
+    reception_us = maintenant_us;
+    en_attente = true;
+}
+
+bool adressage_creneau(uint32_t maintenant_us, uint8_t masque[NB_DONNEES], size_t &longueur)
+{
+    if (!en_attente || maintenant_us - reception_us < static_cast<uint32_t>(noeud) * ADRESSAGE_CRENEAU_US)
+        return false;
+
+    for (size_t i = 0; i < longueur_groupe; i++)
+    {
+        masque[i] = masque_groupe[i];
+    }
+    longueur = longueur_groupe;
+    en_attente = false;
+    return true;
+}
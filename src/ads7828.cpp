@@ -0,0 +1,43 @@
+#include "ads7828.h"
+
+#include "bus_i2c.h"
+
+// Bits de l'octet de commande
+#define ADS7828_SIMPLE 0x80       // entrée simple (référencée à COM)
+#define ADS7828_REFERENCE_ON 0x08 // référence interne 2,5 V active
+#define ADS7828_ADC_ON 0x04       // convertisseur actif entre les conversions
+
+// Une seule conversion en vol par canal : on mémorise la fonction de chaque canal
+static void (*fins[8])(uint16_t code, uint32_t contexte) = {nullptr};
+static uint32_t contextes[8] = {0};
+
+static void fin_transaction(const uint8_t *lecture, bool reussie, uint32_t canal)
+{
+    if (!reussie || fins[canal] == nullptr)
+        return;
+
+    uint16_t code = static_cast<uint16_t>(((lecture[0] & 0x0F) << 8) | lecture[1]);
+    fins[canal](code, contextes[canal]);
+}
+
+bool ads7828_soumettre(uint8_t canal, void (*fin)(uint16_t code, uint32_t contexte), uint32_t contexte)
+{
+    if (canal > 7)
+        return false;
+
+    fins[canal] = fin;
+    contextes[canal] = contexte;
+
+    // Sélection du canal en mode simple : C2 = bit 0 du canal, C1C0 = bits 2..1
+    uint8_t selection = static_cast<uint8_t>(((canal >> 1) | ((canal & 1) << 2)) << 4);
+
+    TransactionI2C transaction = {};
+    transaction.adresse = ADS7828_ADRESSE;
+    transaction.ecriture[0] = ADS7828_SIMPLE | selection | ADS7828_REFERENCE_ON | ADS7828_ADC_ON;
+    transaction.nb_ecriture = 1;
+    transaction.nb_lecture = 2;
+    transaction.fin = fin_transaction;
+    transaction.point = POINT_I2C_ADS7828;
+    transaction.contexte = canal;
+    return bus_i2c_soumettre(transaction);
+}
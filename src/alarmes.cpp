@@ -0,0 +1,120 @@
+#include "alarmes.h"
+
+/*
+ * Structure : SeuilAlarme
+ * But : Réglage et état de l'alarme d'une donnée
+ */
+struct SeuilAlarme
+{
+    int16_t seuil;
+    uint16_t hysteresis;
+    bool active;
+    bool declenchee;
+    int16_t valeur; // valeur au dernier changement d'état
+};
+
+static SeuilAlarme seuils[NB_DONNEES] = {};
+static uint8_t a_envoyer = 0; // bit i : changement de la donnée i en attente
+static uint8_t sequence = 0;
+
+static int16_t saturer(float valeur)
+{
+    if (valeur >= 32767.0f)
+        return 32767;
+    if (valeur <= -32768.0f)
+        return -32768;
+    return static_cast<int16_t>(valeur < 0 ? valeur - 0.5f : valeur + 0.5f);
+}
+
+static void changer_etat(Donnee donnee, bool declenchee, int16_t valeur)
+{
+    SeuilAlarme &s = seuils[donnee];
+    if (s.declenchee == declenchee)
+        return;
+
+    s.declenchee = declenchee;
+    s.valeur = valeur;
+    a_envoyer |= static_cast<uint8_t>(1u << donnee);
+}
+
+bool alarmes_configurer(uint8_t donnee, int16_t seuil, uint16_t hysteresis, bool active)
+{
+    if (donnee >= NB_DONNEES)
+        return false;
+
+    SeuilAlarme &s = seuils[donnee];
+    s.seuil = seuil;
+    s.hysteresis = hysteresis;
+    s.active = active;
+    if (!active)
+        changer_etat(static_cast<Donnee>(donnee), false, s.valeur);
+    return true;
+}
+
+bool alarmes_configuration(uint8_t donnee, int16_t &seuil, uint16_t &hysteresis, bool &active)
+{
+    if (donnee >= NB_DONNEES)
+        return false;
+
+    seuil = seuils[donnee].seuil;
+    hysteresis = seuils[donnee].hysteresis;
+    active = seuils[donnee].active;
+    return true;
+}
+
+void alarmes_evaluer(Donnee donnee, float valeur)
+{
+    const SeuilAlarme &s = seuils[donnee];
+    if (!s.active)
+        return;
+
+    int16_t entier = saturer(valeur);
+    if (!s.declenchee && entier >= s.seuil)
+        changer_etat(donnee, true, entier);
+    else if (s.declenchee && static_cast<int32_t>(entier) <= static_cast<int32_t>(s.seuil) - s.hysteresis)
+        changer_etat(donnee, false, entier);
+}
+
+bool alarmes_en_attente()
+{
+    return a_envoyer != 0;
+}
+
+bool alarmes_trame(uint8_t donnees[8])
+{
+    if (a_envoyer == 0)
+        return false;
+
+    uint8_t donnee = 0;
+    while (!(a_envoyer & (1u << donnee)))
+    {
+        donnee++;
+    }
+
+    const SeuilAlarme &s = seuils[donnee];
+    uint8_t actives = 0;
+    for (uint8_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (seuils[i].declenchee)
+            actives |= static_cast<uint8_t>(1u << i);
+    }
+
+    donnees[0] = donnee;
+    donnees[1] = s.declenchee ? 1 : 0;
+    donnees[2] = static_cast<uint8_t>(s.valeur);
+    donnees[3] = static_cast<uint8_t>(static_cast<uint16_t>(s.valeur) >> 8);
+    donnees[4] = static_cast<uint8_t>(s.seuil);
+    donnees[5] = static_cast<uint8_t>(static_cast<uint16_t>(s.seuil) >> 8);
+    donnees[6] = actives;
+    donnees[7] = sequence;
+    return true;
+}
+
+void alarmes_envoyee(uint8_t donnee)
+{
+    if (donnee >= NB_DONNEES)
+        return;
+
+    a_envoyer = static_cast<uint8_t>(a_envoyer & ~(1u << donnee));
+    sequence++;
+}
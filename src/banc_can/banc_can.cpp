@@ -0,0 +1,194 @@
+/*
+Banc d'essai CAN du projet capteur (programme de la carte de mesure)
+
+Ce programme tourne sur une deuxième Nucleo F446RE reliée au même bus que
+la carte capteur (env:nucleo_f446re_banc_can). Il envoie des requêtes 0x1A4
+en parcourant les 63 masques possibles, à des débits croissants, et mesure
+le temps entre chaque requête et la trame 0x1A5 correspondante.
+
+Les réponses sont servies dans l'ordre des requêtes : chaque 0x1A5 reçue
+est associée à la plus ancienne requête sans réponse. Une requête sans
+réponse après BANC_DELAI_PERTE_US est comptée perdue. La carte capteur doit
+être dans le format de réponse standard (commande 0x03 = 0).
+
+Résultats sur le port série (115200 bauds), une ligne CSV par débit :
+    debit_hz,envoyees,recues,perdues,p50_us,p99_us,max_us
+puis une dernière ligne « debit_max_sans_perte_hz,<valeur> ».
+*/
+
+#include <Arduino.h>
+#include <algorithm>
+#include "STM32_CAN.h"
+#include "protocole.h"
+
+// Base des identifiants de la carte capteur testée (nœud 0 par défaut)
+#ifndef BANC_ID_BASE
+#define BANC_ID_BASE CAN_ID_BASE
+#endif
+
+// Débits essayés (requêtes par seconde) et nombre de requêtes par débit
+static const uint32_t debits_hz[] = {50, 100, 200, 500, 1000, 2000, 3000, 4000, 5000};
+#define BANC_REQUETES_PAR_DEBIT 1000
+
+// Délai au-delà duquel une requête est considérée perdue (µs)
+#define BANC_DELAI_PERTE_US 20000
+
+// Requêtes en vol au plus (puissance de 2)
+#define BANC_EN_VOL 64
+
+STM32_CAN Can(CAN1, DEF); // PA11/12 pins pour CAN1
+
+static uint32_t latences_us[BANC_REQUETES_PAR_DEBIT];
+static uint32_t nb_latences = 0;
+
+// Instants d'envoi des requêtes sans réponse, du plus ancien au plus récent
+static uint32_t envois_us[BANC_EN_VOL];
+static uint32_t tete = 0;
+static uint32_t queue = 0;
+static uint32_t perdues = 0;
+
+/*
+ * Fonction : remplir_masque
+ * But : Construit le masque de la requête : bit i du numéro = donnée i demandée
+ */
+static void remplir_masque(uint8_t numero, uint8_t masque[NB_DONNEES])
+{
+    for (uint8_t i = 0; i < NB_DONNEES; i++)
+    {
+        masque[i] = (numero & (1u << i)) ? DONNEE_DEMANDEE : 0x00;
+    }
+}
+
+/*
+ * Fonction : recevoir
+ * But : Associe les réponses reçues aux requêtes en vol et compte les pertes
+ */
+static void recevoir()
+{
+    CAN_message_t trame;
+    while (Can.read(trame))
+    {
+        if (trame.id != BANC_ID_BASE + CAN_DECALAGE_REPONSE_1 || tete == queue)
+            continue;
+
+        uint32_t latence = micros() - envois_us[tete % BANC_EN_VOL];
+        tete++;
+        if (nb_latences < BANC_REQUETES_PAR_DEBIT)
+            latences_us[nb_latences++] = latence;
+    }
+
+    // Les requêtes trop anciennes ne recevront plus de réponse
+    while (tete != queue && micros() - envois_us[tete % BANC_EN_VOL] > BANC_DELAI_PERTE_US)
+    {
+        tete++;
+        perdues++;
+    }
+}
+
+/*
+ * Fonction : centile
+ * But : Valeur du centile demandé parmi les latences mesurées (triées)
+ */
+static uint32_t centile(uint32_t pourcentage)
+{
+    if (nb_latences == 0)
+        return 0;
+    uint32_t rang = (nb_latences - 1) * pourcentage / 100;
+    return latences_us[rang];
+}
+
+/*
+ * Fonction : mesurer_debit
+ * But : Envoie BANC_REQUETES_PAR_DEBIT requêtes au débit donné et affiche le résultat
+ * Retour :
+ *    - nombre de requêtes perdues
+ */
+static uint32_t mesurer_debit(uint32_t debit_hz)
+{
+    uint32_t periode_us = 1000000UL / debit_hz;
+    uint32_t envoyees = 0;
+    nb_latences = 0;
+    perdues = 0;
+    tete = queue = 0;
+
+    CAN_message_t requete;
+    requete.id = BANC_ID_BASE + CAN_DECALAGE_REQUETE;
+    requete.len = NB_DONNEES;
+
+    uint32_t prochain_us = micros();
+    while (envoyees < BANC_REQUETES_PAR_DEBIT)
+    {
+        recevoir();
+
+        // Comparaison signée pour rester valide au débordement de micros()
+        if (static_cast<int32_t>(micros() - prochain_us) < 0)
+            continue;
+
+        // File des requêtes en vol pleine : la plus ancienne est perdue
+        if (queue - tete == BANC_EN_VOL)
+        {
+            tete++;
+            perdues++;
+        }
+
+        remplir_masque(static_cast<uint8_t>(1 + envoyees % 63), requete.buf);
+        envois_us[queue % BANC_EN_VOL] = micros();
+        if (Can.write(requete))
+        {
+            queue++;
+            envoyees++;
+        }
+        prochain_us += periode_us;
+    }
+
+    // Attente des dernières réponses
+    uint32_t fin_us = micros();
+    while (tete != queue && micros() - fin_us < 2 * BANC_DELAI_PERTE_US)
+    {
+        recevoir();
+    }
+
+    std::sort(latences_us, latences_us + nb_latences);
+
+    Serial.print(debit_hz);
+    Serial.print(',');
+    Serial.print(envoyees);
+    Serial.print(',');
+    Serial.print(nb_latences);
+    Serial.print(',');
+    Serial.print(perdues);
+    Serial.print(',');
+    Serial.print(centile(50));
+    Serial.print(',');
+    Serial.print(centile(99));
+    Serial.print(',');
+    Serial.println(nb_latences ? latences_us[nb_latences - 1] : 0);
+    return perdues;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    // Même débit que la carte capteur
+    Can.begin();
+    Can.setBaudRate(500000);
+
+    delay(1000);
+    Serial.println("debit_hz,envoyees,recues,perdues,p50_us,p99_us,max_us");
+
+    uint32_t debit_max = 0;
+    for (uint32_t debit_hz : debits_hz)
+    {
+        if (mesurer_debit(debit_hz) == 0)
+            debit_max = debit_hz;
+        delay(100);
+    }
+
+    Serial.print("debit_max_sans_perte_hz,");
+    Serial.println(debit_max);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,39 @@
+#include "bme280_profils.h"
+
+#include "bus_i2c.h"
+
+/*
+ * Fonction : soumettre_ecritures
+ * But : Écrit deux registres en une transaction (paires registre, valeur)
+ */
+static void soumettre_ecritures(uint8_t adresse, uint8_t registre_1, uint8_t valeur_1, uint8_t registre_2,
+                                uint8_t valeur_2)
+{
+    TransactionI2C transaction = {};
+    transaction.adresse = adresse;
+    transaction.ecriture[0] = registre_1;
+    transaction.ecriture[1] = valeur_1;
+    transaction.ecriture[2] = registre_2;
+    transaction.ecriture[3] = valeur_2;
+    transaction.nb_ecriture = 4;
+    transaction.point = POINT_I2C_BME280;
+    bus_i2c_soumettre(transaction);
+}
+
+bool bme280_soumettre_profil(uint8_t adresse, ProfilBme280 profil)
+{
+    // Les deux transactions sont soumises ensemble : seule, la première
+    // laisserait le capteur en veille
+    if (profil >= NB_PROFILS_BME280 || bus_i2c_places_libres() < 2)
+        return false;
+
+    const ReglageBme280 &r = profils_bme280[profil];
+
+    // config n'est pris en compte qu'en veille ; ctrl_hum ne l'est qu'à
+    // l'écriture suivante de ctrl_meas
+    soumettre_ecritures(adresse, BME280_REG_CTRL_MEAS, BME280_MODE_VEILLE, BME280_REG_CONFIG,
+                        static_cast<uint8_t>((r.veille << 5) | (r.filtre << 2)));
+    soumettre_ecritures(adresse, BME280_REG_CTRL_HUM, r.osrs_h, BME280_REG_CTRL_MEAS,
+                        static_cast<uint8_t>((r.osrs_t << 5) | (r.osrs_p << 2) | BME280_MODE_NORMAL));
+    return true;
+}
@@ -0,0 +1,102 @@
+#include "bme280_rafale.h"
+
+#include "bus_i2c.h"
+
+static BME280 *capteur_rafale = nullptr;
+static void (*fin_rafale)(const Bme280Mesure &mesure) = nullptr;
+
+/*
+ * Fonction : compenser_temperature
+ * Retour :
+ *    - t_fine, utilisé ensuite par la pression et l'humidité
+ */
+static int32_t compenser_temperature(const SensorCalibration &c, int32_t adc_T)
+{
+    int32_t var1 = ((((adc_T >> 3) - (static_cast<int32_t>(c.dig_T1) << 1))) * static_cast<int32_t>(c.dig_T2)) >> 11;
+    int32_t var2 = (((((adc_T >> 4) - static_cast<int32_t>(c.dig_T1)) * ((adc_T >> 4) - static_cast<int32_t>(c.dig_T1))) >> 12) *
+                    static_cast<int32_t>(c.dig_T3)) >> 14;
+    return var1 + var2;
+}
+
+/*
+ * Fonction : compenser_pression
+ * Retour :
+ *    - pression en Pa au format Q24.8
+ */
+static uint32_t compenser_pression(const SensorCalibration &c, int32_t adc_P, int32_t t_fine)
+{
+    int64_t var1 = static_cast<int64_t>(t_fine) - 128000;
+    int64_t var2 = var1 * var1 * static_cast<int64_t>(c.dig_P6);
+    var2 = var2 + ((var1 * static_cast<int64_t>(c.dig_P5)) << 17);
+    var2 = var2 + (static_cast<int64_t>(c.dig_P4) << 35);
+    var1 = ((var1 * var1 * static_cast<int64_t>(c.dig_P3)) >> 8) + ((var1 * static_cast<int64_t>(c.dig_P2)) << 12);
+    var1 = (((static_cast<int64_t>(1) << 47) + var1)) * static_cast<int64_t>(c.dig_P1) >> 33;
+    if (var1 == 0)
+        return 0; // évite une division par zéro
+
+    int64_t p = 1048576 - adc_P;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (static_cast<int64_t>(c.dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (static_cast<int64_t>(c.dig_P8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (static_cast<int64_t>(c.dig_P7) << 4);
+    return static_cast<uint32_t>(p);
+}
+
+/*
+ * Fonction : compenser_humidite
+ * Retour :
+ *    - humidité en %RH au format Q22.10
+ */
+static uint32_t compenser_humidite(const SensorCalibration &c, int32_t adc_H, int32_t t_fine)
+{
+    int32_t v = t_fine - static_cast<int32_t>(76800);
+    v = (((((adc_H << 14) - (static_cast<int32_t>(c.dig_H4) << 20) - (static_cast<int32_t>(c.dig_H5) * v)) +
+           static_cast<int32_t>(16384)) >> 15) *
+         (((((((v * static_cast<int32_t>(c.dig_H6)) >> 10) *
+              (((v * static_cast<int32_t>(c.dig_H3)) >> 11) + static_cast<int32_t>(32768))) >> 10) +
+            static_cast<int32_t>(2097152)) * static_cast<int32_t>(c.dig_H2) + 8192) >> 14));
+    v = (v - (((((v >> 15) * (v >> 15)) >> 7) * static_cast<int32_t>(c.dig_H1)) >> 4));
+    v = (v < 0 ? 0 : v);
+    v = (v > 419430400 ? 419430400 : v);
+    return static_cast<uint32_t>(v >> 12);
+}
+
+void bme280_compenser(const SensorCalibration &calibration, const uint8_t brut[BME280_TAILLE_DONNEES],
+                      Bme280Mesure &mesure)
+{
+    int32_t adc_P = (static_cast<int32_t>(brut[0]) << 12) | (static_cast<int32_t>(brut[1]) << 4) | (brut[2] >> 4);
+    int32_t adc_T = (static_cast<int32_t>(brut[3]) << 12) | (static_cast<int32_t>(brut[4]) << 4) | (brut[5] >> 4);
+    int32_t adc_H = (static_cast<int32_t>(brut[6]) << 8) | brut[7];
+
+    // Une seule compensation de la température, partagée par les trois sorties
+    int32_t t_fine = compenser_temperature(calibration, adc_T);
+
+    mesure.temperature_c = ((t_fine * 5 + 128) >> 8) / 100.0f;
+    mesure.pression_pa = compenser_pression(calibration, adc_P, t_fine) / 256.0f;
+    mesure.humidite_pct = compenser_humidite(calibration, adc_H, t_fine) / 1024.0f;
+}
+
+static void fin_transaction(const uint8_t *lecture, bool reussie, uint32_t)
+{
+    if (!reussie || capteur_rafale == nullptr || fin_rafale == nullptr)
+        return;
+
+    Bme280Mesure mesure;
+    bme280_compenser(capteur_rafale->calibration, lecture, mesure);
+    fin_rafale(mesure);
+}
+
+bool bme280_soumettre_rafale(BME280 &capteur, uint8_t adresse, void (*fin)(const Bme280Mesure &mesure))
+{
+    capteur_rafale = &capteur;
+    fin_rafale = fin;
+
+    TransactionI2C transaction = {};
+    transaction.adresse = adresse;
+    transaction.ecriture[0] = BME280_REG_DONNEES;
+    transaction.nb_ecriture = 1;
+    transaction.nb_lecture = BME280_TAILLE_DONNEES;
+    transaction.fin = fin_transaction;
+    transaction.point = POINT_I2C_BME280;
+    return bus_i2c_soumettre(transaction);
+}
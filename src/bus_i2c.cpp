@@ -0,0 +1,233 @@
+#include "bus_i2c.h"
+
+#include "anneau_spsc.h"
+
+static TwoWire *bus_i2c = nullptr;
+static AnneauSpsc<TransactionI2C, BUS_I2C_TAILLE_FILE> file;
+static uint32_t recuperations = 0;
+static uint32_t erreurs = 0;
+static uint32_t nacks = 0;
+static uint32_t transactions = 0;
+
+// Étape de la transaction en cours, exécutée par l'interruption I2C1
+enum Phase : uint8_t
+{
+    PHASE_REPOS,
+    PHASE_ECRITURE,
+    PHASE_LECTURE
+};
+
+static Phase phase = PHASE_REPOS;
+static TransactionI2C courante;
+static uint8_t lecture[BUS_I2C_MAX_LECTURE];
+static uint32_t debut_cycles = 0;
+static uint32_t debut_us = 0;
+
+void bus_i2c_init(TwoWire &bus)
+{
+    bus_i2c = &bus;
+    bus.begin();
+    bus.setClock(BUS_I2C_FREQUENCE);
+}
+
+bool bus_i2c_soumettre(const TransactionI2C &transaction)
+{
+    if (transaction.nb_ecriture > BUS_I2C_MAX_ECRITURE || transaction.nb_lecture > BUS_I2C_MAX_LECTURE)
+        return false;
+    return file.pousser(transaction);
+}
+
+/*
+ * Fonction : terminer
+ * But : Comptabilise la transaction en cours et appelle sa fonction de rappel
+ * Paramètres :
+ *    - reussie : tous les octets ont été acquittés et lus
+ *    - erreur_bus : erreur de bus, d'arbitrage ou délai dépassé (récupération du bus)
+ */
+static void terminer(bool reussie, bool erreur_bus)
+{
+    phase = PHASE_REPOS;
+
+    // Échec sans erreur de bus : l'esclave n'a pas acquitté
+    transactions++;
+    if (!reussie && !erreur_bus)
+        nacks++;
+
+    instrumentation_ajouter(courante.point, cycles_lire() - debut_cycles);
+
+    if (erreur_bus)
+    {
+        erreurs++;
+        reussie = false;
+        bus_i2c_recuperer();
+    }
+
+    if (courante.fin != nullptr)
+        courante.fin(lecture, reussie, courante.contexte);
+}
+
+/*
+ * Fonction : lancer
+ * But : Démarre l'écriture ou la lecture de la transaction en cours en mode
+ *       interruption ; le périphérique refusant le transfert (bus occupé)
+ *       est traité comme une erreur de bus
+ */
+static void lancer(Phase suivante)
+{
+    I2C_HandleTypeDef *i2c = bus_i2c->getHandle();
+    uint16_t adresse = static_cast<uint16_t>(courante.adresse << 1);
+    HAL_StatusTypeDef resultat = suivante == PHASE_ECRITURE
+                                     ? HAL_I2C_Master_Transmit_IT(i2c, adresse, courante.ecriture, courante.nb_ecriture)
+                                     : HAL_I2C_Master_Receive_IT(i2c, adresse, lecture, courante.nb_lecture);
+    if (resultat != HAL_OK)
+    {
+        terminer(false, true);
+        return;
+    }
+    phase = suivante;
+}
+
+/*
+ * Fonction : demarrer_suivante
+ * But : Retire la prochaine transaction de la file et lance son premier transfert
+ */
+static void demarrer_suivante()
+{
+    if (!file.retirer(courante))
+        return;
+
+    // SDA tenu bas alors qu'aucun transfert n'est en cours : un esclave est bloqué
+    if (digitalRead(BUS_I2C_SDA) == LOW)
+        bus_i2c_recuperer();
+
+    memset(lecture, 0, sizeof(lecture));
+    debut_cycles = cycles_lire();
+    debut_us = micros();
+
+    if (courante.nb_ecriture > 0)
+        lancer(PHASE_ECRITURE);
+    else if (courante.nb_lecture > 0)
+        lancer(PHASE_LECTURE);
+    else
+        terminer(true, false);
+}
+
+// Délai de la transaction en cours dépassé : le bus est considéré bloqué
+static bool delai_depasse()
+{
+    return micros() - debut_us > BUS_I2C_DELAI_MAX_US;
+}
+
+void bus_i2c_executer()
+{
+    if (bus_i2c == nullptr)
+        return;
+
+    if (phase != PHASE_REPOS)
+    {
+        I2C_HandleTypeDef *i2c = bus_i2c->getHandle();
+        if (HAL_I2C_GetState(i2c) != HAL_I2C_STATE_READY)
+        {
+            if (!delai_depasse())
+                return;
+            terminer(false, true);
+        }
+        else if (HAL_I2C_GetError(i2c) != HAL_I2C_ERROR_NONE)
+        {
+            // Absence d'acquittement seule : l'esclave a refusé l'adresse ou un octet
+            terminer(false, (HAL_I2C_GetError(i2c) & ~HAL_I2C_ERROR_AF) != 0);
+        }
+        else if (phase == PHASE_ECRITURE && courante.nb_lecture > 0)
+        {
+            // STOP puis lecture, comme endTransmission() suivi de requestFrom()
+            lancer(PHASE_LECTURE);
+            return;
+        }
+        else
+        {
+            terminer(true, false);
+        }
+    }
+
+    if (phase == PHASE_REPOS)
+        demarrer_suivante();
+}
+
+bool bus_i2c_en_attente()
+{
+    if (phase == PHASE_REPOS)
+        return file.taille() != 0;
+    return HAL_I2C_GetState(bus_i2c->getHandle()) == HAL_I2C_STATE_READY || delai_depasse();
+}
+
+bool bus_i2c_au_repos()
+{
+    return phase == PHASE_REPOS;
+}
+
+size_t bus_i2c_places_libres()
+{
+    return file.capacite() - file.taille();
+}
+
+void bus_i2c_recuperer()
+{
+    if (bus_i2c == nullptr)
+        return;
+
+    bus_i2c->end();
+
+    // SCL en drain ouvert piloté à la main ; SDA relâché
+    pinMode(BUS_I2C_SDA, INPUT);
+    pinMode(BUS_I2C_SCL, OUTPUT_OPEN_DRAIN);
+    digitalWrite(BUS_I2C_SCL, HIGH);
+    delayMicroseconds(5);
+
+    // Jusqu'à 9 impulsions (8 bits + acquittement) pour que l'esclave libère SDA, à ~100 kHz
+    for (int i = 0; i < 9 && digitalRead(BUS_I2C_SDA) == LOW; i++)
+    {
+        digitalWrite(BUS_I2C_SCL, LOW);
+        delayMicroseconds(5);
+        digitalWrite(BUS_I2C_SCL, HIGH);
+        delayMicroseconds(5);
+    }
+
+    // Condition STOP : SDA monte pendant que SCL est haut
+    pinMode(BUS_I2C_SDA, OUTPUT_OPEN_DRAIN);
+    digitalWrite(BUS_I2C_SCL, LOW);
+    digitalWrite(BUS_I2C_SDA, LOW);
+    delayMicroseconds(5);
+    digitalWrite(BUS_I2C_SCL, HIGH);
+    delayMicroseconds(5);
+    digitalWrite(BUS_I2C_SDA, HIGH);
+    delayMicroseconds(5);
+
+    // Remise à zéro du périphérique (registres et état BUSY éventuellement bloqué)
+    RCC->APB1RSTR |= RCC_APB1RSTR_I2C1RST;
+    RCC->APB1RSTR &= ~RCC_APB1RSTR_I2C1RST;
+
+    // begin() reconfigure les broches en fonction alternée
+    bus_i2c->begin();
+    bus_i2c->setClock(BUS_I2C_FREQUENCE);
+    recuperations++;
+}
+
+uint32_t bus_i2c_recuperations()
+{
+    return recuperations;
+}
+
+uint32_t bus_i2c_erreurs()
+{
+    return erreurs;
+}
+
+uint32_t bus_i2c_nacks()
+{
+    return nacks;
+}
+
+uint32_t bus_i2c_transactions()
+{
+    return transactions;
+}
@@ -0,0 +1,235 @@
+#include "cache_reponses.h"
+
+#include "acquisition.h"
+#include "adressage.h"
+#include "capteurs.h"
+
+/*
+ * Structure : FenetresFraicheur
+ * But : Fenêtre de fraîcheur de chaque donnée, initialisée à la compilation
+ *       avec la période de rafraîchissement de table_donnees
+ */
+struct FenetresFraicheur
+{
+    uint16_t ms[NB_DONNEES];
+    uint16_t minimum_ms[NB_DONNEES]; // période de lecture imposée par le capteur
+
+    constexpr FenetresFraicheur() : ms(), minimum_ms()
+    {
+        for (size_t i = 0; i < NB_DONNEES; i++)
+        {
+            ms[i] = table_donnees[i].periode_ms;
+        }
+    }
+};
+
+static FenetresFraicheur fenetres;
+
+// Fenêtre appliquée : celle de la configuration, jamais plus courte que le minimum
+static uint16_t fenetre(size_t donnee)
+{
+    return fenetres.ms[donnee] > fenetres.minimum_ms[donnee] ? fenetres.ms[donnee] : fenetres.minimum_ms[donnee];
+}
+
+// Version d'une donnée dont aucun capteur n'est disponible
+#define VERSION_INDISPONIBLE 0xFFFFFFFFUL
+
+// Image complète des données encodées et horodatage d'acquisition de chaque donnée
+static uint8_t image[TAILLE_DONNEES] = {0};
+static uint32_t versions_image[NB_DONNEES] = {0};
+static bool image_valide[NB_DONNEES] = {false};
+
+/*
+ * Structure : ModeleReponse
+ * But : Trames prêtes à envoyer pour un masque
+ */
+struct ModeleReponse
+{
+    uint8_t demandees;              // bit i : donnée i demandée
+    uint8_t longueur;               // longueur du masque reçu
+    CAN_message_t trames[2];        // 0x1A5 et 0x1A6
+    uint32_t versions[NB_DONNEES];  // horodatage d'acquisition des octets copiés
+    uint32_t encodages[NB_DONNEES]; // instant de la dernière copie des octets
+    uint32_t utilisation;           // dernier usage, pour remplacer le plus ancien
+    bool valide;
+};
+
+static ModeleReponse modeles[CACHE_NB_MODELES] = {};
+
+/*
+ * Fonction : ecrire_octet
+ * But : Écrit un octet à sa position dans les trames d'un modèle (0 à 7 : 0x1A5, 8 : 0x1A6)
+ */
+static inline void ecrire_octet(ModeleReponse &modele, size_t position, uint8_t octet)
+{
+    if (position < 8)
+        modele.trames[0].buf[position] = octet;
+    else
+        modele.trames[1].buf[0] = octet;
+}
+
+/*
+ * Fonction : version_donnee
+ * But : Horodatage d'acquisition d'une donnée, ou VERSION_INDISPONIBLE
+ */
+static uint32_t version_donnee(Donnee donnee)
+{
+    return capteurs_donnee_disponible(donnee) ? acquisition_horodatage(donnee) : VERSION_INDISPONIBLE;
+}
+
+/*
+ * Fonction : mettre_a_jour_image
+ * But : Réencode une donnée dans l'image complète si sa valeur a changé
+ *       (0xFF si aucun capteur ne la fournit)
+ */
+static void mettre_a_jour_image(Donnee donnee)
+{
+    uint32_t version = version_donnee(donnee);
+    if (image_valide[donnee] && versions_image[donnee] == version)
+        return;
+
+    if (version == VERSION_INDISPONIBLE)
+    {
+        for (size_t j = 0; j < taille_donnee(donnee); j++)
+        {
+            image[position_donnee(donnee) + j] = 0xFF;
+        }
+    }
+    else
+    {
+        encoder_donnee(acquisition_mesures(), donnee, image);
+    }
+    versions_image[donnee] = version;
+    image_valide[donnee] = true;
+}
+
+/*
+ * Fonction : copier_donnee
+ * But : Recopie les octets d'une donnée de l'image vers un modèle
+ */
+static void copier_donnee(ModeleReponse &modele, Donnee donnee, uint32_t maintenant)
+{
+    size_t position = position_donnee(donnee);
+    for (size_t j = 0; j < taille_donnee(donnee); j++)
+    {
+        ecrire_octet(modele, position + j, image[position + j]);
+    }
+    modele.versions[donnee] = versions_image[donnee];
+    modele.encodages[donnee] = maintenant;
+}
+
+/*
+ * Fonction : preparer_modele
+ * But : Construit les trames d'un nouveau masque (les données non demandées
+ *       valent 0xFF, les octets au-delà du masque reçu valent 0)
+ */
+static void preparer_modele(ModeleReponse &modele, uint8_t demandees, uint8_t longueur, uint32_t maintenant)
+{
+    modele.demandees = demandees;
+    modele.longueur = longueur;
+    modele.trames[0].id = adressage_id(CAN_DECALAGE_REPONSE_1);
+    modele.trames[0].len = 8;
+    modele.trames[1].id = adressage_id(CAN_DECALAGE_REPONSE_2);
+    modele.trames[1].len = 1;
+
+    for (size_t position = 0; position < TAILLE_DONNEES; position++)
+    {
+        ecrire_octet(modele, position, 0);
+    }
+
+    for (size_t i = 0; i < longueur; i++)
+    {
+        Donnee donnee = static_cast<Donnee>(i);
+        if (demandees & (1u << i))
+        {
+            mettre_a_jour_image(donnee);
+            copier_donnee(modele, donnee, maintenant);
+        }
+        else
+        {
+            for (size_t j = 0; j < taille_donnee(donnee); j++)
+            {
+                ecrire_octet(modele, position_donnee(donnee) + j, 0xFF);
+            }
+        }
+    }
+    modele.valide = true;
+}
+
+/*
+ * Fonction : trouver_modele
+ * But : Donne le modèle d'un masque, ou le modèle le moins récemment utilisé
+ *       préparé pour ce masque
+ */
+static ModeleReponse &trouver_modele(uint8_t demandees, uint8_t longueur, uint32_t maintenant)
+{
+    ModeleReponse *remplace = &modeles[0];
+    for (size_t i = 0; i < CACHE_NB_MODELES; i++)
+    {
+        ModeleReponse &modele = modeles[i];
+        if (modele.valide && modele.demandees == demandees && modele.longueur == longueur)
+            return modele;
+        if (!modele.valide || (remplace->valide && modele.utilisation < remplace->utilisation))
+            remplace = &modele;
+    }
+
+    preparer_modele(*remplace, demandees, longueur, maintenant);
+    return *remplace;
+}
+
+uint8_t cache_reponse(const uint8_t *masque, size_t longueur, uint32_t maintenant, CAN_message_t *trames[2])
+{
+    static uint32_t compteur_utilisation = 0;
+
+    if (longueur > NB_DONNEES)
+        longueur = NB_DONNEES;
+
+    uint8_t demandees = decoder_masque(masque, longueur);
+
+    ModeleReponse &modele = trouver_modele(demandees, static_cast<uint8_t>(longueur), maintenant);
+    modele.utilisation = ++compteur_utilisation;
+
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (!(demandees & (1u << i)))
+            continue;
+
+        Donnee donnee = static_cast<Donnee>(i);
+        uint32_t version = version_donnee(donnee);
+
+        // Seules les données trop anciennes déclenchent une lecture du capteur
+        if (maintenant - acquisition_horodatage(donnee) > fenetre(i))
+            acquisition_rafraichir(donnee, maintenant);
+
+        // Octets réencodés seulement si la valeur a changé et que la fenêtre est écoulée ;
+        // un changement de disponibilité est recopié immédiatement
+        bool disponibilite_changee = (modele.versions[i] == VERSION_INDISPONIBLE) != (version == VERSION_INDISPONIBLE);
+        if (modele.versions[i] != version && (disponibilite_changee || maintenant - modele.encodages[i] > fenetre(i)))
+        {
+            mettre_a_jour_image(donnee);
+            copier_donnee(modele, donnee, maintenant);
+        }
+    }
+
+    trames[0] = &modele.trames[0];
+    trames[1] = &modele.trames[1];
+    return (demandees & donnees_trame_2()) ? 2 : 1;
+}
+
+bool cache_modifier_fenetre(uint8_t donnee, uint16_t fenetre_ms)
+{
+    if (donnee >= NB_DONNEES)
+        return false;
+
+    fenetres.ms[donnee] = fenetre_ms;
+    return true;
+}
+
+bool cache_modifier_fenetre_minimale(uint8_t donnee, uint16_t minimum_ms)
+{
+    if (donnee >= NB_DONNEES)
+        return false;
+
+    fenetres.minimum_ms[donnee] = minimum_ms;
+    return true;
+}
@@ -0,0 +1,112 @@
+#include "can_rx.h"
+
+#include "anneau_spsc.h"
+#include "cycles.h"
+#include "vecteurs.h"
+
+static AnneauSpsc<CAN_message_t, CAN_RX_TAILLE_ANNEAU> anneau_rx;
+static volatile uint32_t debordements_fifo = 0;
+static volatile uint32_t trames_recues = 0;
+static volatile uint32_t cycles_interruption = 0;
+static uint8_t banques_filtre = 0; // banques déjà configurées par can_rx_filtrer()
+
+/*
+ * Fonction : can_rx_isr
+ * But : Copie toutes les trames présentes dans la FIFO0 vers le tampon circulaire
+ */
+static void can_rx_isr(void)
+{
+    cycles_interruption = cycles_lire();
+
+    while (CAN1->RF0R & CAN_RF0R_FMP0)
+    {
+        CAN_FIFOMailBox_TypeDef &boite = CAN1->sFIFOMailBox[0];
+        CAN_message_t message;
+
+        uint32_t rir = boite.RIR;
+        if (rir & CAN_RI0R_IDE)
+        {
+            message.id = rir >> CAN_RI0R_EXID_Pos;
+            message.flags.extended = 1;
+        }
+        else
+        {
+            message.id = rir >> CAN_RI0R_STID_Pos;
+        }
+        message.flags.remote = (rir & CAN_RI0R_RTR) != 0;
+
+        uint32_t rdtr = boite.RDTR;
+        uint8_t dlc = rdtr & CAN_RDT0R_DLC;
+        message.len = dlc > 8 ? 8 : dlc;
+        // Le compteur TIME du bxCAN n'est pas lisible : millis() sert d'horodatage
+        message.timestamp = static_cast<uint16_t>(millis());
+
+        uint32_t bas = boite.RDLR;
+        uint32_t haut = boite.RDHR;
+        for (int i = 0; i < 4; i++)
+        {
+            message.buf[i] = static_cast<uint8_t>(bas >> (8 * i));
+            message.buf[i + 4] = static_cast<uint8_t>(haut >> (8 * i));
+        }
+
+        // Libère la boîte de la FIFO (les bits FULL0/FOVR0 ne sont pas touchés par un 0)
+        CAN1->RF0R = CAN_RF0R_RFOM0;
+
+        trames_recues = trames_recues + 1;
+        anneau_rx.pousser(message);
+    }
+
+    if (CAN1->RF0R & CAN_RF0R_FOVR0)
+    {
+        debordements_fifo = debordements_fifo + 1;
+        CAN1->RF0R = CAN_RF0R_FOVR0;
+    }
+}
+
+void can_rx_init()
+{
+    vecteurs_remplacer(CAN1_RX0_IRQn, can_rx_isr);
+}
+
+bool can_rx_filtrer(STM32_CAN &can, uint32_t id, uint32_t masque)
+{
+    if (banques_filtre > MB13)
+        return false;
+
+    // Toutes les banques désactivées, puis une banque en mode masque vers la FIFO0 par appel
+    if (banques_filtre == MB0)
+        can.setMBFilter(REJECT_ALL);
+    can.setMBFilterProcessing(static_cast<CAN_BANK>(banques_filtre), id, masque, STD);
+    banques_filtre++;
+    return true;
+}
+
+bool can_rx_lire(CAN_message_t &message)
+{
+    return anneau_rx.retirer(message);
+}
+
+bool can_rx_en_attente()
+{
+    return anneau_rx.taille() != 0;
+}
+
+uint32_t can_rx_cycles_interruption()
+{
+    return cycles_interruption;
+}
+
+uint32_t can_rx_debordements_anneau()
+{
+    return anneau_rx.debordements();
+}
+
+uint32_t can_rx_debordements_fifo()
+{
+    return debordements_fifo;
+}
+
+uint32_t can_rx_recues()
+{
+    return trames_recues;
+}
@@ -0,0 +1,143 @@
+#include "can_tx.h"
+
+#include "anneau_spsc.h"
+#include "vecteurs.h"
+
+// Remplies par la boucle principale, vidées par l'interruption d'émission
+static AnneauSpsc<CAN_message_t, CAN_TX_TAILLE_FILE> files[NB_PRIORITES_TX];
+static volatile uint32_t trames_envoyees = 0;
+static volatile uint32_t trames_echouees = 0;
+static volatile uint32_t boites_pleines = 0;
+
+// Bits de fin de transmission (RQCP) et de succès (TXOK) de chaque boîte
+static const uint32_t fins_boites[3] = {CAN_TSR_RQCP0, CAN_TSR_RQCP1, CAN_TSR_RQCP2};
+static const uint32_t succes_boites[3] = {CAN_TSR_TXOK0, CAN_TSR_TXOK1, CAN_TSR_TXOK2};
+
+/*
+ * Fonction : charger_boites
+ * But : Place les trames les plus prioritaires dans les boîtes d'émission libres
+ */
+static void charger_boites()
+{
+    while (true)
+    {
+        // Trames en attente mais aucune boîte libre : le bus ne suit pas
+        if (!(CAN1->TSR & CAN_TSR_TME))
+        {
+            for (size_t i = 0; i < NB_PRIORITES_TX; i++)
+            {
+                if (files[i].taille() != 0)
+                {
+                    boites_pleines = boites_pleines + 1;
+                    break;
+                }
+            }
+            return;
+        }
+
+        CAN_message_t trame;
+        size_t priorite = 0;
+        while (priorite < NB_PRIORITES_TX && !files[priorite].retirer(trame))
+        {
+            priorite++;
+        }
+        if (priorite == NB_PRIORITES_TX)
+            return;
+
+        // CODE : numéro d'une boîte libre
+        CAN_TxMailBox_TypeDef &boite = CAN1->sTxMailBox[(CAN1->TSR & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos];
+
+        uint8_t longueur = trame.len > 8 ? 8 : trame.len;
+        boite.TDTR = longueur;
+        boite.TDLR = static_cast<uint32_t>(trame.buf[0]) | (static_cast<uint32_t>(trame.buf[1]) << 8) |
+                     (static_cast<uint32_t>(trame.buf[2]) << 16) | (static_cast<uint32_t>(trame.buf[3]) << 24);
+        boite.TDHR = static_cast<uint32_t>(trame.buf[4]) | (static_cast<uint32_t>(trame.buf[5]) << 8) |
+                     (static_cast<uint32_t>(trame.buf[6]) << 16) | (static_cast<uint32_t>(trame.buf[7]) << 24);
+
+        uint32_t tir = trame.flags.extended ? (trame.id << CAN_TI0R_EXID_Pos) | CAN_TI0R_IDE
+                                            : (trame.id << CAN_TI0R_STID_Pos);
+        if (trame.flags.remote)
+            tir |= CAN_TI0R_RTR;
+
+        // Demande de transmission en dernier : la boîte est alors complète
+        boite.TIR = tir | CAN_TI0R_TXRQ;
+    }
+}
+
+/*
+ * Fonction : can_tx_isr
+ * But : Acquitte les boîtes dont la transmission est terminée et les recharge
+ */
+static void can_tx_isr(void)
+{
+    uint32_t tsr = CAN1->TSR;
+    for (int i = 0; i < 3; i++)
+    {
+        if (!(tsr & fins_boites[i]))
+            continue;
+        if (tsr & succes_boites[i])
+            trames_envoyees = trames_envoyees + 1;
+        else
+            trames_echouees = trames_echouees + 1;
+    }
+
+    // RQCPx s'efface en écrivant 1 (TXOKx, ALSTx et TERRx avec lui)
+    CAN1->TSR = tsr & (CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2);
+
+    charger_boites();
+}
+
+void can_tx_init()
+{
+    vecteurs_remplacer(CAN1_TX_IRQn, can_tx_isr);
+
+    // TXFP n'est modifiable qu'en mode initialisation
+    CAN1->MCR |= CAN_MCR_INRQ;
+    while (!(CAN1->MSR & CAN_MSR_INAK))
+    {
+    }
+    CAN1->MCR |= CAN_MCR_TXFP;
+    CAN1->MCR &= ~CAN_MCR_INRQ;
+    while (CAN1->MSR & CAN_MSR_INAK)
+    {
+    }
+
+    CAN1->IER |= CAN_IER_TMEIE;
+    NVIC_EnableIRQ(CAN1_TX_IRQn);
+}
+
+bool can_tx_envoyer(const CAN_message_t &trame, PrioriteTx priorite)
+{
+    if (!files[priorite].pousser(trame))
+        return false;
+
+    // L'interruption est le seul consommateur des files : elle est déclenchée
+    // par logiciel pour charger une boîte déjà libre
+    NVIC_SetPendingIRQ(CAN1_TX_IRQn);
+    return true;
+}
+
+uint32_t can_tx_envoyees()
+{
+    return trames_envoyees;
+}
+
+uint32_t can_tx_debordements()
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < NB_PRIORITES_TX; i++)
+    {
+        total += files[i].debordements();
+    }
+    return total;
+}
+
+uint32_t can_tx_echouees()
+{
+    return trames_echouees;
+}
+
+uint32_t can_tx_boites_pleines()
+{
+    return boites_pleines;
+}
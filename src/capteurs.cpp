@@ -0,0 +1,266 @@
+#include "capteurs.h"
+
+#include "acquisition.h"
+#include "adc_interne.h"
+#include "ads7828.h"
+#include "bus_i2c.h"
+#include "configuration.h"
+#include "scd41.h"
+
+/*
+ * Structure : EtatCapteur
+ * But : Disponibilité et planification des réessais d'un capteur
+ */
+struct EtatCapteur
+{
+    bool disponible;
+    uint32_t derniere_mesure; // millis() de la dernière mesure produite
+    uint32_t echeance;        // prochaine tentative d'initialisation
+    uint32_t attente_ms;      // délai avant la tentative suivante
+    uint8_t echecs;           // tentatives échouées (saturé à 255)
+    bool demarrage;           // initialisé, disponible à sa première mesure (SCD41)
+};
+
+static EtatCapteur etats[NB_CAPTEURS] = {};
+
+static const uint32_t silences_ms[NB_CAPTEURS] = {
+    CAPTEUR_SILENCE_ADS7828_MS,
+    CAPTEUR_SILENCE_BME280_MS,
+    CAPTEUR_SILENCE_SCD41_MS,
+};
+
+// Adresse du BME280 retenue à sa dernière initialisation
+static uint8_t adresse_bme280 = BME280_ADRESSE;
+
+static bool etat_modifie = false;
+static uint32_t derniere_publication = 0;
+
+/*
+ * Fonction : repond
+ * But : Vérifie qu'un esclave acquitte son adresse (aucun octet transféré)
+ */
+static bool repond(uint8_t adresse)
+{
+    myWire.beginTransmission(adresse);
+    return myWire.endTransmission() == 0;
+}
+
+/*
+ * Fonction : initialiser
+ * But : Tente d'initialiser un capteur, en vérifiant d'abord sa présence
+ */
+static bool initialiser(Capteur capteur)
+{
+    switch (capteur)
+    {
+    case CAPTEUR_ADS7828:
+#ifdef GAZ_ADC_INTERNE
+        // ADC interne : toujours présent, relancé si le DMA s'est arrêté
+        return adc_interne_init();
+#else
+        // Aucune configuration : chaque conversion porte son octet de commande
+        return repond(ADS7828_ADRESSE);
+#endif
+    case CAPTEUR_BME280:
+        adresse_bme280 = configuration().adresse_bme280;
+        BME280_Sensor.setI2CAddress(adresse_bme280);
+        // beginI2C() charge les coefficients et les réglages de la librairie,
+        // remplacés ensuite par ceux du profil courant
+        return repond(adresse_bme280) && BME280_Sensor.beginI2C(myWire) &&
+               bme280_soumettre_profil(adresse_bme280, acquisition_profil_bme280());
+    case CAPTEUR_SCD41:
+        // Démarrage non bloquant : un échec est signalé par scd41_en_defaut()
+        if (!repond(SCD41_ADRESSE))
+            return false;
+        scd41_demarrer(SCD41_BASSE_CONSOMMATION);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void changer_disponibilite(EtatCapteur &etat, bool disponible)
+{
+    if (etat.disponible != disponible)
+        etat_modifie = true;
+    etat.disponible = disponible;
+}
+
+/*
+ * Fonction : compter_echec
+ * But : Compte une tentative échouée et double le délai avant la suivante
+ */
+static void compter_echec(EtatCapteur &etat, uint32_t maintenant)
+{
+    if (etat.echecs < 255)
+        etat.echecs++;
+    etat.echeance = maintenant + etat.attente_ms;
+    etat.attente_ms = etat.attente_ms * 2 > CAPTEURS_ATTENTE_MAX_MS ? CAPTEURS_ATTENTE_MAX_MS : etat.attente_ms * 2;
+}
+
+// Première donnée produite par un capteur, relue dès son initialisation
+static Donnee premiere_donnee(Capteur capteur)
+{
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (table_donnees[i].source == capteur)
+            return static_cast<Donnee>(i);
+    }
+    return NB_DONNEES;
+}
+
+void capteurs_init(uint32_t maintenant)
+{
+    for (size_t i = 0; i < NB_CAPTEURS; i++)
+    {
+        etats[i] = EtatCapteur{};
+        etats[i].echeance = maintenant;
+        etats[i].attente_ms = CAPTEURS_ATTENTE_MIN_MS;
+    }
+    etat_modifie = true;
+}
+
+void capteurs_surveiller(uint32_t maintenant)
+{
+    for (size_t i = 0; i < NB_CAPTEURS; i++)
+    {
+        EtatCapteur &etat = etats[i];
+        bool silencieux = maintenant - etat.derniere_mesure > silences_ms[i];
+
+        // Démarrage en échec ou sans première mesure : tentative échouée
+        if (etat.demarrage && (silencieux || (i == CAPTEUR_SCD41 && scd41_en_defaut())))
+        {
+            etat.demarrage = false;
+            compter_echec(etat, maintenant);
+        }
+        else if (etat.disponible && silencieux)
+        {
+            changer_disponibilite(etat, false);
+            etat.echeance = maintenant;
+            etat.attente_ms = CAPTEURS_ATTENTE_MIN_MS;
+        }
+    }
+
+    // Les tentatives utilisent TwoWire directement : pas pendant un transfert de la file
+    if (!bus_i2c_au_repos())
+        return;
+
+    // Une seule tentative par exécution pour borner la durée de la tâche
+    for (size_t i = 0; i < NB_CAPTEURS; i++)
+    {
+        EtatCapteur &etat = etats[i];
+
+        // Comparaison signée pour rester valide au débordement de millis()
+        if (etat.disponible || etat.demarrage || static_cast<int32_t>(maintenant - etat.echeance) < 0)
+            continue;
+
+        Capteur capteur = static_cast<Capteur>(i);
+        if (!initialiser(capteur))
+        {
+            compter_echec(etat, millis());
+        }
+        else if (capteur == CAPTEUR_SCD41)
+        {
+            // Disponible à la première mesure lue par sa machine à états (voir capteur_actif())
+            etat.derniere_mesure = millis();
+            etat.demarrage = true;
+        }
+        else
+        {
+            // Le délai de silence repart de l'initialisation
+            etat.derniere_mesure = millis();
+            etat.attente_ms = CAPTEURS_ATTENTE_MIN_MS;
+            changer_disponibilite(etat, true);
+
+            // Première lecture sans attendre la période de la tâche
+            acquisition_rafraichir(premiere_donnee(capteur), millis());
+        }
+        return;
+    }
+}
+
+bool capteur_disponible(Capteur capteur)
+{
+    return etats[capteur].disponible;
+}
+
+bool capteur_en_service(Capteur capteur)
+{
+    return etats[capteur].disponible || etats[capteur].demarrage;
+}
+
+void capteur_actif(Capteur capteur, uint32_t maintenant)
+{
+    EtatCapteur &etat = etats[capteur];
+    etat.derniere_mesure = maintenant;
+    if (etat.demarrage)
+    {
+        etat.demarrage = false;
+        etat.attente_ms = CAPTEURS_ATTENTE_MIN_MS;
+        changer_disponibilite(etat, true);
+    }
+}
+
+bool capteurs_donnee_disponible(Donnee donnee)
+{
+    if (donnee >= NB_DONNEES)
+        return false;
+
+    uint8_t disponibles = 0;
+    for (size_t i = 0; i < NB_CAPTEURS; i++)
+    {
+        if (etats[i].disponible)
+            disponibles |= FOURNISSEUR(i);
+    }
+    return (table_donnees[donnee].fournisseurs & disponibles) != 0;
+}
+
+uint8_t capteurs_donnees_disponibles()
+{
+    uint8_t donnees = 0;
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        if (capteurs_donnee_disponible(static_cast<Donnee>(i)))
+            donnees = static_cast<uint8_t>(donnees | (1u << i));
+    }
+    return donnees;
+}
+
+uint32_t capteurs_age_ms(Capteur capteur, uint32_t maintenant)
+{
+    if (capteur >= NB_CAPTEURS || !etats[capteur].disponible)
+        return UINT32_MAX;
+    return maintenant - etats[capteur].derniere_mesure;
+}
+
+uint8_t capteurs_adresse_bme280()
+{
+    return adresse_bme280;
+}
+
+bool capteurs_etat_a_publier(uint32_t maintenant)
+{
+    bool tous_disponibles = true;
+    for (size_t i = 0; i < NB_CAPTEURS; i++)
+    {
+        tous_disponibles = tous_disponibles && etats[i].disponible;
+    }
+
+    if (!etat_modifie && (tous_disponibles || maintenant - derniere_publication < CAPTEURS_PERIODE_ETAT_MS))
+        return false;
+
+    etat_modifie = false;
+    derniere_publication = maintenant;
+    return true;
+}
+
+void capteurs_trame_etat(uint8_t donnees[8])
+{
+    donnees[0] = 0;
+    for (size_t i = 0; i < NB_CAPTEURS; i++)
+    {
+        if (etats[i].disponible)
+            donnees[0] |= static_cast<uint8_t>(1u << i);
+        donnees[1 + i] = etats[i].echecs;
+    }
+}
@@ -0,0 +1,129 @@
+#include "commandes.h"
+
+#include "alarmes.h"
+#include "configuration.h"
+#include "conversion_gaz.h"
+
+static uint32_t lire_u32(const uint8_t *octets)
+{
+    return static_cast<uint32_t>(octets[0]) | (static_cast<uint32_t>(octets[1]) << 8) |
+           (static_cast<uint32_t>(octets[2]) << 16) | (static_cast<uint32_t>(octets[3]) << 24);
+}
+
+static void ecrire_u32(uint32_t valeur, uint8_t *octets)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        octets[i] = static_cast<uint8_t>(valeur >> (8 * i));
+    }
+}
+
+uint8_t commande_traiter(const uint8_t *donnees, size_t longueur, uint8_t reponse[8], uint32_t maintenant)
+{
+    if (longueur == 0)
+        return 0;
+
+    reponse[0] = donnees[0];
+    reponse[1] = CMD_STATUT_ERREUR;
+
+    switch (donnees[0])
+    {
+    case CMD_ECRIRE_R0:
+    {
+        if (longueur >= 6 && configuration_ecrire_champ(CHAMP_R0, donnees[1], lire_u32(&donnees[2]), maintenant) &&
+            configuration_sauvegarder())
+            reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    case CMD_LIRE_R0:
+    {
+        if (longueur < 2 || donnees[1] >= NB_GAZ)
+            return 2;
+
+        const CalibrationGaz &calibration = conversion_calibration(static_cast<CapteurGaz>(donnees[1]));
+        reponse[1] = CMD_STATUT_OK;
+        reponse[2] = donnees[1];
+        ecrire_u32(static_cast<uint32_t>(calibration.r0_kohm * 1000.0f + 0.5f), &reponse[3]);
+        return 7;
+    }
+    case CMD_FORMAT:
+    {
+        if (longueur >= 2 && configuration_ecrire_champ(CHAMP_FORMAT, 0, donnees[1], maintenant))
+            reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    case CMD_FENETRE:
+    {
+        if (longueur >= 4 && configuration_ecrire_champ(CHAMP_FENETRE, donnees[1],
+                                                        static_cast<uint32_t>(donnees[2] | (donnees[3] << 8)), maintenant))
+            reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    case CMD_ECRIRE_SEUIL:
+    {
+        if (longueur < 7)
+            return 2;
+
+        // Réglage complet validé puis écrit d'un bloc : jamais de seuil à moitié modifié
+        int16_t seuil = static_cast<int16_t>(donnees[2] | (donnees[3] << 8));
+        uint16_t hysteresis = static_cast<uint16_t>(donnees[4] | (donnees[5] << 8));
+        if (configuration_ecrire_seuil(donnees[1], seuil, hysteresis, donnees[6] != 0))
+            reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    case CMD_LIRE_SEUIL:
+    {
+        int16_t seuil;
+        uint16_t hysteresis;
+        bool active;
+        if (longueur < 2 || !alarmes_configuration(donnees[1], seuil, hysteresis, active))
+            return 2;
+
+        reponse[1] = CMD_STATUT_OK;
+        reponse[2] = donnees[1];
+        reponse[3] = static_cast<uint8_t>(seuil);
+        reponse[4] = static_cast<uint8_t>(static_cast<uint16_t>(seuil) >> 8);
+        reponse[5] = static_cast<uint8_t>(hysteresis);
+        reponse[6] = static_cast<uint8_t>(hysteresis >> 8);
+        reponse[7] = active ? 1 : 0;
+        return 8;
+    }
+    case CMD_LIRE_CHAMP:
+    {
+        uint32_t valeur;
+        if (longueur < 3 || !configuration_lire_champ(donnees[1], donnees[2], valeur))
+            return 2;
+
+        reponse[1] = CMD_STATUT_OK;
+        reponse[2] = donnees[1];
+        reponse[3] = donnees[2];
+        ecrire_u32(valeur, &reponse[4]);
+        return 8;
+    }
+    case CMD_ECRIRE_CHAMP:
+    {
+        if (longueur >= 7 && configuration_ecrire_champ(donnees[1], donnees[2], lire_u32(&donnees[3]), maintenant))
+            reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    case CMD_SAUVEGARDER:
+    {
+        if (configuration_sauvegarder())
+            reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    case CMD_DEFAUTS:
+    {
+        configuration_defauts(maintenant);
+        reponse[1] = CMD_STATUT_OK;
+        return 2;
+    }
+    default:
+        return 2;
+    }
+}
+
+FormatReponse commande_format()
+{
+    return static_cast<FormatReponse>(configuration().format);
+}
@@ -0,0 +1,311 @@
+#include "configuration.h"
+
+#include "acquisition.h"
+#include "alarmes.h"
+#include "cache_reponses.h"
+#include "diffusion.h"
+#include "donnees.h"
+#include "protocole.h"
+#include "stockage.h"
+
+static_assert(sizeof(Configuration) <= STOCKAGE_TAILLE_MAX, "La configuration doit tenir dans un enregistrement");
+
+/*
+ * Structure : R0Sauvegardes
+ * But : Enregistrement des versions précédentes (R0 seulement), repris une fois
+ */
+struct R0Sauvegardes
+{
+    float r0_kohm[NB_GAZ];
+};
+
+static Configuration config;
+
+/*
+ * Fonction : remplir_defauts
+ * But : Valeurs de compilation de tous les champs
+ */
+static void remplir_defauts(Configuration &c)
+{
+    c = Configuration{};
+    c.version = CONFIGURATION_VERSION;
+    c.adresse_bme280 = BME280_ADRESSE;
+    c.format = FORMAT_STANDARD;
+    c.debit_can = CONFIGURATION_DEBIT_CAN;
+    c.base_can = CAN_ID_BASE;
+    c.periode_diffusion_ms = 0;
+    c.diffusion_donnees = 0;
+    c.profil_bme280 = PROFIL_BME280_DEFAUT;
+
+    for (int capteur = 0; capteur < NB_GAZ; capteur++)
+    {
+        const CalibrationGaz &calibration = conversion_calibration_defaut(static_cast<CapteurGaz>(capteur));
+        c.courbes[capteur] = {calibration.m, calibration.b, calibration.r0_kohm};
+    }
+
+    // Fenêtre de fraîcheur = période de rafraîchissement de la donnée ; alarmes désactivées
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        c.fenetres_ms[i] = table_donnees[i].periode_ms;
+        c.seuils[i] = SeuilConfigure{};
+    }
+}
+
+static bool debit_valide(uint32_t debit)
+{
+    return debit == 125000 || debit == 250000 || debit == 500000 || debit == 1000000;
+}
+
+static bool base_valide(uint32_t base)
+{
+    // Même contraintes que les static_assert de protocole.h sur CAN_ID_BASE
+    return (base & ~CAN_MASQUE_BLOC) == 0 && base >= CAN_TAILLE_BLOC &&
+           base + CAN_TAILLE_BLOC * CAN_NB_NOEUDS <= 0x800;
+}
+
+// Arrondi d'un réel en millièmes (pente et ordonnée, valeurs signées)
+static uint32_t en_milliemes(float valeur)
+{
+    return static_cast<uint32_t>(static_cast<int32_t>(valeur < 0 ? valeur * 1000.0f - 0.5f : valeur * 1000.0f + 0.5f));
+}
+
+static void appliquer_seuil(uint8_t donnee)
+{
+    const SeuilConfigure &s = config.seuils[donnee];
+    alarmes_configurer(donnee, s.seuil, s.hysteresis, s.active != 0);
+}
+
+// Le profil n'impose qu'un minimum aux fenêtres du BME280 : les valeurs configurées sont conservées
+static void appliquer_profil()
+{
+    acquisition_choisir_profil_bme280(static_cast<ProfilBme280>(config.profil_bme280));
+}
+
+static void appliquer_diffusion(uint32_t maintenant)
+{
+    diffusion_definir(config.diffusion_donnees, config.periode_diffusion_ms, maintenant);
+}
+
+const Configuration &configuration_charger()
+{
+    // Une seule lecture : le dernier enregistrement valide de la bonne taille
+    bool lue = stockage_lire(&config, sizeof(config));
+
+    // La version 1 a la même taille ; le profil occupait son alignement
+    if (lue && config.version == 1)
+    {
+        config.version = CONFIGURATION_VERSION;
+        config.profil_bme280 = PROFIL_BME280_DEFAUT;
+    }
+
+    if (lue && config.version == CONFIGURATION_VERSION && debit_valide(config.debit_can) &&
+        base_valide(config.base_can) && config.profil_bme280 < NB_PROFILS_BME280)
+        return config;
+
+    remplir_defauts(config);
+
+    // Première mise en service après une version qui ne sauvegardait que les R0
+    R0Sauvegardes ancienne;
+    if (stockage_lire(&ancienne, sizeof(ancienne)))
+    {
+        for (int capteur = 0; capteur < NB_GAZ; capteur++)
+        {
+            if (ancienne.r0_kohm[capteur] > 0.0f)
+                config.courbes[capteur].r0_kohm = ancienne.r0_kohm[capteur];
+        }
+    }
+    return config;
+}
+
+const Configuration &configuration()
+{
+    return config;
+}
+
+void configuration_appliquer(uint32_t maintenant)
+{
+    conversion_init(config.courbes);
+
+    for (uint8_t i = 0; i < NB_DONNEES; i++)
+    {
+        cache_modifier_fenetre(i, config.fenetres_ms[i]);
+        appliquer_seuil(i);
+    }
+
+    appliquer_diffusion(maintenant);
+    appliquer_profil();
+}
+
+bool configuration_lire_champ(uint8_t champ, uint8_t index, uint32_t &valeur)
+{
+    // Champs indexés par capteur de gaz ou par donnée
+    bool par_gaz = champ == CHAMP_R0 || champ == CHAMP_PENTE || champ == CHAMP_ORDONNEE;
+    bool par_donnee = champ == CHAMP_FENETRE || champ == CHAMP_SEUIL || champ == CHAMP_HYSTERESIS ||
+                      champ == CHAMP_ALARME_ACTIVE;
+    if ((par_gaz && index >= NB_GAZ) || (par_donnee && index >= NB_DONNEES))
+        return false;
+
+    switch (champ)
+    {
+    case CHAMP_VERSION:
+        valeur = config.version;
+        return true;
+    case CHAMP_DEBIT_CAN:
+        valeur = config.debit_can;
+        return true;
+    case CHAMP_BASE_CAN:
+        valeur = config.base_can;
+        return true;
+    case CHAMP_ADRESSE_BME280:
+        valeur = config.adresse_bme280;
+        return true;
+    case CHAMP_R0:
+        valeur = static_cast<uint32_t>(config.courbes[index].r0_kohm * 1000.0f + 0.5f);
+        return true;
+    case CHAMP_PENTE:
+        valeur = en_milliemes(config.courbes[index].m);
+        return true;
+    case CHAMP_ORDONNEE:
+        valeur = en_milliemes(config.courbes[index].b);
+        return true;
+    case CHAMP_FENETRE:
+        valeur = config.fenetres_ms[index];
+        return true;
+    case CHAMP_SEUIL:
+        valeur = static_cast<uint32_t>(static_cast<int32_t>(config.seuils[index].seuil));
+        return true;
+    case CHAMP_HYSTERESIS:
+        valeur = config.seuils[index].hysteresis;
+        return true;
+    case CHAMP_ALARME_ACTIVE:
+        valeur = config.seuils[index].active;
+        return true;
+    case CHAMP_FORMAT:
+        valeur = config.format;
+        return true;
+    case CHAMP_DIFFUSION_DONNEES:
+        valeur = config.diffusion_donnees;
+        return true;
+    case CHAMP_DIFFUSION_PERIODE:
+        valeur = config.periode_diffusion_ms;
+        return true;
+    case CHAMP_PROFIL_BME280:
+        valeur = config.profil_bme280;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool configuration_ecrire_champ(uint8_t champ, uint8_t index, uint32_t valeur, uint32_t maintenant)
+{
+    int32_t signe = static_cast<int32_t>(valeur);
+    CapteurGaz capteur = static_cast<CapteurGaz>(index);
+
+    switch (champ)
+    {
+    case CHAMP_DEBIT_CAN:
+        if (!debit_valide(valeur))
+            return false;
+        config.debit_can = valeur;
+        return true;
+    case CHAMP_BASE_CAN:
+        if (!base_valide(valeur))
+            return false;
+        config.base_can = static_cast<uint16_t>(valeur);
+        return true;
+    case CHAMP_ADRESSE_BME280:
+        if (valeur != 0x76 && valeur != 0x77)
+            return false;
+        config.adresse_bme280 = static_cast<uint8_t>(valeur);
+        return true;
+    case CHAMP_R0:
+        if (index >= NB_GAZ || !conversion_modifier_r0(capteur, valeur / 1000.0f))
+            return false;
+        config.courbes[index].r0_kohm = valeur / 1000.0f;
+        return true;
+    case CHAMP_PENTE:
+        if (index >= NB_GAZ || !conversion_modifier_courbe(capteur, signe / 1000.0f, config.courbes[index].b))
+            return false;
+        config.courbes[index].m = signe / 1000.0f;
+        return true;
+    case CHAMP_ORDONNEE:
+        if (index >= NB_GAZ || !conversion_modifier_courbe(capteur, config.courbes[index].m, signe / 1000.0f))
+            return false;
+        config.courbes[index].b = signe / 1000.0f;
+        return true;
+    case CHAMP_FENETRE:
+        if (valeur > UINT16_MAX || !cache_modifier_fenetre(index, static_cast<uint16_t>(valeur)))
+            return false;
+        config.fenetres_ms[index] = static_cast<uint16_t>(valeur);
+        return true;
+    case CHAMP_SEUIL:
+        if (index >= NB_DONNEES || signe < INT16_MIN || signe > INT16_MAX)
+            return false;
+        config.seuils[index].seuil = static_cast<int16_t>(signe);
+        appliquer_seuil(index);
+        return true;
+    case CHAMP_HYSTERESIS:
+        if (index >= NB_DONNEES || valeur > UINT16_MAX)
+            return false;
+        config.seuils[index].hysteresis = static_cast<uint16_t>(valeur);
+        appliquer_seuil(index);
+        return true;
+    case CHAMP_ALARME_ACTIVE:
+        if (index >= NB_DONNEES || valeur > 1)
+            return false;
+        config.seuils[index].active = static_cast<uint8_t>(valeur);
+        appliquer_seuil(index);
+        return true;
+    case CHAMP_FORMAT:
+        if (valeur > FORMAT_COMPACT)
+            return false;
+        config.format = static_cast<uint8_t>(valeur);
+        return true;
+    case CHAMP_DIFFUSION_DONNEES:
+        if (valeur >= (1u << NB_DONNEES))
+            return false;
+        config.diffusion_donnees = static_cast<uint8_t>(valeur);
+        appliquer_diffusion(maintenant);
+        return true;
+    case CHAMP_DIFFUSION_PERIODE:
+        if (valeur > UINT16_MAX)
+            return false;
+        config.periode_diffusion_ms = static_cast<uint16_t>(valeur);
+        appliquer_diffusion(maintenant);
+        return true;
+    case CHAMP_PROFIL_BME280:
+        if (valeur >= NB_PROFILS_BME280)
+            return false;
+        config.profil_bme280 = static_cast<uint8_t>(valeur);
+        appliquer_profil();
+        return true;
+    default:
+        // CHAMP_VERSION est en lecture seule
+        return false;
+    }
+}
+
+bool configuration_ecrire_seuil(uint8_t donnee, int16_t seuil, uint16_t hysteresis, bool active)
+{
+    // Niveau de retour (seuil - hystérésis) représentable : bas <= haut dans l'unité de la donnée
+    if (donnee >= NB_DONNEES || static_cast<int32_t>(seuil) - hysteresis < INT16_MIN)
+        return false;
+
+    SeuilConfigure reglage = {seuil, hysteresis, static_cast<uint8_t>(active ? 1 : 0)};
+    config.seuils[donnee] = reglage;
+    appliquer_seuil(donnee);
+    return configuration_sauvegarder();
+}
+
+bool configuration_sauvegarder()
+{
+    return stockage_ecrire(&config, sizeof(config));
+}
+
+void configuration_defauts(uint32_t maintenant)
+{
+    // Le débit et la base du bus ne changent qu'au prochain démarrage
+    remplir_defauts(config);
+    configuration_appliquer(maintenant);
+}
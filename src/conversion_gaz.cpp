@@ -0,0 +1,165 @@
+#include "conversion_gaz.h"
+
+#include <math.h>
+
+#ifdef GAZ_ADC_INTERNE
+#include "adc_interne.h"
+#endif
+
+uint16_t table_ppm[NB_GAZ][CONVERSION_NB_CODES];
+
+// Pleine échelle de l'ADC des gaz : VDDA de la Nucleo pour l'ADC interne,
+// référence interne de l'ADS7828 (REFERENCE_ON) sinon. Seul l'ADC interne
+// lit les capteurs à travers un pont diviseur (voir adc_interne.h).
+#ifdef GAZ_ADC_INTERNE
+#define VREF_GAZ 3.3f
+#define PONT_GAZ ADC_INTERNE_PONT_DIVISEUR
+#else
+#define VREF_GAZ 2.5f
+#define PONT_GAZ 1.0f
+#endif
+
+// Calibrations par défaut : ADC 12 bits, capteurs alimentés en 5 V.
+// La courbe du MQ7 reprend celle du MQ4 en attendant une calibration propre.
+static const CalibrationGaz calibrations_defaut[NB_GAZ] = {
+    {-0.318f, 1.133f, VREF_GAZ, PONT_GAZ, 5.0f, 1.0f, 5.5f, 12}, // GAZ_METHANE
+    {-0.318f, 1.133f, VREF_GAZ, PONT_GAZ, 5.0f, 1.0f, 5.5f, 12}, // GAZ_CO
+};
+
+// Calibrations courantes (copiées des valeurs par défaut par conversion_init())
+static CalibrationGaz calibrations[NB_GAZ];
+
+/*
+ * Fonction : computePPM
+ * But : Calcule une concentration en ppm à partir d'une lecture brute du capteur analogique
+ * Paramètres :
+ *    - calibration : descripteur du capteur
+ *    - sensorValue : code brut de l'ADC
+ * Retour :
+ *    - La concentration estimée en ppm sous forme d'un entier 16 bits non signé (uint16_t)
+ */
+uint16_t computePPM(const CalibrationGaz &calibration, float sensorValue)
+{
+    // Tension en sortie du capteur, en amont de l'éventuel pont diviseur
+    float voltage = sensorValue * (calibration.vref * calibration.pont / (1UL << calibration.resolution));
+    if (voltage <= 0.0f)
+        return 0; // RS infinie : aucune concentration mesurable
+
+    float RS_gas = calibration.rl_kohm * (calibration.vc - voltage) / voltage;
+    float ratio = RS_gas / calibration.r0_kohm;
+    if (ratio <= 0.0f)
+        return 65535; // tension au-delà de l'alimentation : saturation
+
+    float ppm_log = (log10f(ratio) - calibration.b) / calibration.m;
+    float ppm = powf(10.0f, ppm_log);
+
+    if (ppm < 0.0f)
+        return 0;
+    if (ppm > 65535.0f)
+        return 65535;
+
+    return static_cast<uint16_t>(ppm + 0.5f);
+}
+
+/*
+ * Fonction : remplir_table
+ * But : Calcule la table d'un capteur ; les codes au-delà de la résolution
+ *       de l'ADC reprennent la valeur du code maximal
+ */
+static void remplir_table(CapteurGaz capteur)
+{
+    const CalibrationGaz &calibration = calibrations[capteur];
+    uint32_t nb_codes = 1UL << calibration.resolution;
+
+    for (uint32_t code = 0; code < CONVERSION_NB_CODES; code++)
+    {
+        uint32_t code_valide = code < nb_codes ? code : nb_codes - 1;
+        table_ppm[capteur][code] = computePPM(calibration, static_cast<float>(code_valide));
+    }
+}
+
+void conversion_init(const CourbeGaz *courbes)
+{
+    for (int capteur = 0; capteur < NB_GAZ; capteur++)
+    {
+        calibrations[capteur] = calibrations_defaut[capteur];
+        if (courbes == nullptr)
+            continue;
+
+        const CourbeGaz &courbe = courbes[capteur];
+        if (courbe.m != 0.0f)
+        {
+            calibrations[capteur].m = courbe.m;
+            calibrations[capteur].b = courbe.b;
+        }
+        if (courbe.r0_kohm > 0.0f)
+            calibrations[capteur].r0_kohm = courbe.r0_kohm;
+    }
+
+    for (int capteur = 0; capteur < NB_GAZ; capteur++)
+    {
+        remplir_table(static_cast<CapteurGaz>(capteur));
+    }
+}
+
+bool conversion_modifier_r0(CapteurGaz capteur, float r0_kohm)
+{
+    if (capteur >= NB_GAZ || !(r0_kohm > 0.0f))
+        return false;
+
+    calibrations[capteur].r0_kohm = r0_kohm;
+    remplir_table(capteur);
+    return true;
+}
+
+bool conversion_modifier_courbe(CapteurGaz capteur, float m, float b)
+{
+    if (capteur >= NB_GAZ || m == 0.0f)
+        return false;
+
+    calibrations[capteur].m = m;
+    calibrations[capteur].b = b;
+    remplir_table(capteur);
+    return true;
+}
+
+const CalibrationGaz &conversion_calibration(CapteurGaz capteur)
+{
+    return calibrations[capteur];
+}
+
+const CalibrationGaz &conversion_calibration_defaut(CapteurGaz capteur)
+{
+    return calibrations_defaut[capteur];
+}
+
+#ifdef BANC_ESSAI_CONVERSION
+#include "cycles.h"
+
+void conversion_banc_essai(Print &sortie)
+{
+    volatile uint32_t puits = 0; // empêche le compilateur d'éliminer les boucles
+    cycles_init();
+
+    uint32_t debut = cycles_lire();
+    for (uint16_t code = 0; code < CONVERSION_NB_CODES; code++)
+    {
+        puits = puits + computePPM(calibrations[GAZ_METHANE], code);
+    }
+    uint32_t cycles_calcul = cycles_lire() - debut;
+
+    debut = cycles_lire();
+    for (uint16_t code = 0; code < CONVERSION_NB_CODES; code++)
+    {
+        puits = puits + conversion_ppm(GAZ_METHANE, code);
+    }
+    uint32_t cycles_table = cycles_lire() - debut;
+
+    sortie.print("computePPM : ");
+    sortie.print(static_cast<float>(cycles_calcul) / CONVERSION_NB_CODES);
+    sortie.println(" cycles/conversion");
+    sortie.print("table      : ");
+    sortie.print(static_cast<float>(cycles_table) / CONVERSION_NB_CODES);
+    sortie.println(" cycles/conversion");
+}
+#endif
@@ -0,0 +1,51 @@
+#include "diffusion.h"
+
+static uint8_t masque[NB_DONNEES] = {0};
+static uint16_t periode_ms = 0; // 0 : diffusion désactivée
+static uint32_t echeance = 0;
+
+void diffusion_configurer(const uint8_t *donnees, size_t longueur, uint32_t maintenant)
+{
+    if (longueur < NB_DONNEES + 2)
+        return;
+
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        masque[i] = donnees[i];
+    }
+    periode_ms = static_cast<uint16_t>(donnees[NB_DONNEES] | (donnees[NB_DONNEES + 1] << 8));
+    echeance = maintenant;
+}
+
+void diffusion_definir(uint8_t donnees, uint16_t periode, uint32_t maintenant)
+{
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        masque[i] = (donnees & (1u << i)) ? DONNEE_DEMANDEE : 0x00;
+    }
+    periode_ms = periode;
+    echeance = maintenant;
+}
+
+bool diffusion_echeance(uint32_t maintenant)
+{
+    if (periode_ms == 0)
+        return false;
+
+    // Comparaison signée pour rester valide au débordement de millis()
+    if (static_cast<int32_t>(maintenant - echeance) < 0)
+        return false;
+
+    echeance += periode_ms;
+
+    // Après un long blocage, on repart de maintenant plutôt que de rattraper
+    if (static_cast<int32_t>(maintenant - echeance) >= 0)
+        echeance = maintenant + periode_ms;
+
+    return true;
+}
+
+const uint8_t *diffusion_masque()
+{
+    return masque;
+}
@@ -0,0 +1,167 @@
+#include "historique.h"
+
+#include "acquisition.h"
+#include "capteurs.h"
+#include "protocole.h"
+
+#define TAILLE_ENREGISTREMENT 10 // écart (2 octets) et format compact (8 octets)
+#define OCTETS_PAR_TRAME 7
+
+static_assert((HISTORIQUE_CAPACITE & (HISTORIQUE_CAPACITE - 1)) == 0, "HISTORIQUE_CAPACITE doit etre une puissance de 2");
+
+/*
+ * Structure : Enregistrement
+ * But : Mesures encodées au format compact et instant de l'ajout
+ */
+struct Enregistrement
+{
+    uint32_t horodatage;
+    uint8_t compact[8];
+};
+
+static Enregistrement enregistrements[HISTORIQUE_CAPACITE];
+static uint32_t nb_ajouts = 0; // index absolu du prochain enregistrement
+static uint8_t sequence = 0;
+
+// Transfert en cours : enregistrements [premier, premier + nombre)
+static bool en_cours = false;
+static uint32_t premier = 0;
+static uint16_t nombre = 0;
+static uint32_t trame = 0; // 0 : première trame, n : n-ième trame suivante
+
+static uint32_t lire_u32(const uint8_t *octets)
+{
+    return static_cast<uint32_t>(octets[0]) | (static_cast<uint32_t>(octets[1]) << 8) |
+           (static_cast<uint32_t>(octets[2]) << 16) | (static_cast<uint32_t>(octets[3]) << 24);
+}
+
+static const Enregistrement &enregistrement(uint32_t index)
+{
+    return enregistrements[index & (HISTORIQUE_CAPACITE - 1)];
+}
+
+// Un enregistrement est encore présent s'il n'a pas été écrasé par les ajouts suivants
+static bool present(uint32_t index)
+{
+    return nb_ajouts - index <= HISTORIQUE_CAPACITE && index < nb_ajouts;
+}
+
+/*
+ * Fonction : octet_flux
+ * But : Octet k du flux d'enregistrements du transfert
+ */
+static uint8_t octet_flux(uint32_t k)
+{
+    uint32_t index = premier + k / TAILLE_ENREGISTREMENT;
+    uint32_t position = k % TAILLE_ENREGISTREMENT;
+    const Enregistrement &courant = enregistrement(index);
+
+    if (position >= 2)
+        return courant.compact[position - 2];
+
+    uint32_t ecart = index == premier ? 0 : courant.horodatage - enregistrement(index - 1).horodatage;
+    if (ecart > 0xFFFF)
+        ecart = 0xFFFF;
+    return static_cast<uint8_t>(ecart >> (8 * position));
+}
+
+void historique_ajouter(uint32_t maintenant)
+{
+    Enregistrement &nouveau = enregistrements[nb_ajouts & (HISTORIQUE_CAPACITE - 1)];
+    nouveau.horodatage = maintenant;
+    // Les données sans capteur sont marquées indisponibles, comme dans la trame 0x1AB
+    encoder_compact(acquisition_mesures(), capteurs_donnees_disponibles(), sequence++, nouveau.compact);
+    nb_ajouts++;
+}
+
+void historique_demander(const uint8_t *donnees, size_t longueur, uint32_t maintenant)
+{
+    uint32_t debut, fin;
+    if (longueur == 4)
+    {
+        uint32_t duree = lire_u32(donnees);
+        debut = duree < maintenant ? maintenant - duree : 0;
+        fin = maintenant;
+    }
+    else if (longueur == 8)
+    {
+        debut = lire_u32(donnees);
+        fin = lire_u32(&donnees[4]);
+    }
+    else
+    {
+        return;
+    }
+
+    // Parcours du plus récent au plus ancien enregistrement présent
+    uint32_t plus_ancien = nb_ajouts > HISTORIQUE_CAPACITE ? nb_ajouts - HISTORIQUE_CAPACITE : 0;
+    uint32_t dernier = nb_ajouts;
+    while (dernier > plus_ancien && enregistrement(dernier - 1).horodatage > fin)
+    {
+        dernier--;
+    }
+    uint32_t index = dernier;
+    while (index > plus_ancien && enregistrement(index - 1).horodatage >= debut && dernier - index < 0xFFFF)
+    {
+        index--;
+    }
+
+    premier = index;
+    nombre = static_cast<uint16_t>(dernier - index);
+    trame = 0;
+    en_cours = true;
+}
+
+bool historique_en_cours()
+{
+    return en_cours;
+}
+
+bool historique_trame(uint8_t donnees[8])
+{
+    if (!en_cours)
+        return false;
+
+    if (trame == 0)
+    {
+        donnees[0] = HISTORIQUE_PREMIERE_TRAME;
+        donnees[1] = static_cast<uint8_t>(nombre);
+        donnees[2] = static_cast<uint8_t>(nombre >> 8);
+        uint32_t horodatage = nombre ? enregistrement(premier).horodatage : 0;
+        for (int i = 0; i < 4; i++)
+        {
+            donnees[3 + i] = static_cast<uint8_t>(horodatage >> (8 * i));
+        }
+        donnees[7] = 0;
+        return true;
+    }
+
+    uint32_t taille = static_cast<uint32_t>(nombre) * TAILLE_ENREGISTREMENT;
+    uint32_t debut = (trame - 1) * OCTETS_PAR_TRAME;
+
+    // Enregistrements écrasés depuis la requête : le transfert s'arrête
+    uint32_t fin = debut + OCTETS_PAR_TRAME < taille ? debut + OCTETS_PAR_TRAME : taille;
+    if (!present(premier + debut / TAILLE_ENREGISTREMENT) || !present(premier + (fin - 1) / TAILLE_ENREGISTREMENT))
+    {
+        en_cours = false;
+        return false;
+    }
+
+    donnees[0] = static_cast<uint8_t>(HISTORIQUE_TRAME_SUIVANTE | (trame & 0x0F));
+    for (uint32_t i = 0; i < OCTETS_PAR_TRAME; i++)
+    {
+        donnees[1 + i] = debut + i < taille ? octet_flux(debut + i) : 0;
+    }
+    return true;
+}
+
+void historique_avancer()
+{
+    if (!en_cours)
+        return;
+
+    trame++;
+    uint32_t taille = static_cast<uint32_t>(nombre) * TAILLE_ENREGISTREMENT;
+    if ((trame - 1) * OCTETS_PAR_TRAME >= taille)
+        en_cours = false;
+}
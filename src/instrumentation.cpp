@@ -0,0 +1,72 @@
+#include "instrumentation.h"
+
+#define MAX_24_BITS 0xFFFFFFUL
+
+/*
+ * Structure : StatistiquesCycles
+ * But : Statistiques accumulées d'une étape
+ */
+struct StatistiquesCycles
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t nombre;
+};
+
+static StatistiquesCycles statistiques[NB_POINTS] = {};
+
+void instrumentation_ajouter(PointMesure point, uint32_t cycles)
+{
+    StatistiquesCycles &s = statistiques[point];
+    if (s.nombre == 0 || cycles < s.min)
+        s.min = cycles;
+    if (cycles > s.max)
+        s.max = cycles;
+    s.total += cycles;
+    s.nombre++;
+}
+
+void instrumentation_remettre_a_zero()
+{
+    for (int i = 0; i < NB_POINTS; i++)
+    {
+        statistiques[i] = StatistiquesCycles{};
+    }
+}
+
+static void encoder_u24(uint32_t valeur, uint8_t *memoire)
+{
+    if (valeur > MAX_24_BITS)
+        valeur = MAX_24_BITS;
+    memoire[0] = static_cast<uint8_t>(valeur);
+    memoire[1] = static_cast<uint8_t>(valeur >> 8);
+    memoire[2] = static_cast<uint8_t>(valeur >> 16);
+}
+
+void instrumentation_trame(uint8_t numero, uint8_t donnees[8])
+{
+    uint8_t point = numero / 2;
+    const StatistiquesCycles &s = statistiques[point < NB_POINTS ? point : 0];
+
+    donnees[0] = point;
+    donnees[1] = numero % 2;
+    if (donnees[1] == 0)
+    {
+        encoder_u24(s.min, &donnees[2]);
+        encoder_u24(s.max, &donnees[5]);
+    }
+    else
+    {
+        encoder_u24(s.nombre ? static_cast<uint32_t>(s.total / s.nombre) : 0, &donnees[2]);
+        encoder_u24(s.nombre, &donnees[5]);
+    }
+}
+
+void instrumentation_trame_compteurs(uint8_t etiquette, uint32_t premier, uint32_t second, uint8_t donnees[8])
+{
+    donnees[0] = etiquette;
+    donnees[1] = 2;
+    encoder_u24(premier, &donnees[2]);
+    encoder_u24(second, &donnees[5]);
+}
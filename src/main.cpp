@@ -43,7 +43,8 @@ Le STM32 répond de cette façon :
         ID : 0x1A6
         Octet #0 : Pression atmospérique
 
-La deuxième trame CAN sera envoyer uniquement si l'utilisateur demande a recevoir la pression atmosphérique.
+La deuxième trame CAN sera envoyer uniquement si l'utilisateur demande a recevoir la pression atmosphérique
+(selon le masque, même si la pression encodée vaut 0).
 
 Remarques :
 - Si l'utilisateur veut uniquement avoir certaine données, exemple le méthane et la température, les autres octets
@@ -56,6 +57,88 @@ Remarques :
      - Octet LSB (basse valeur) : 0x2C (44 en décimal)
      - Octet MSB (haute valeur) : 0x01 (1 en décimal)
   Trame CAN contiendra donc : [0x2C, 0x01] pour le méthane
+
+Mode diffusion :
+    Pour éviter d'envoyer une requête 0x1A4 à chaque lecture, le maître peut
+    envoyer une trame de configuration sur l'ID 0x1A3 :
+        Octets #0 à #5 : masque (0x11 pour chaque donnée désirée, comme la requête)
+        Octet #6 : période en ms, LSB
+        Octet #7 : période en ms, MSB
+    Le STM32 publie alors les trames 0x1A5/0x1A6 à cette période. Une période
+    de 0 ms désactive la diffusion ; les requêtes 0x1A4 restent toujours servies.
+
+Format compact :
+    La commande 0x03 (voir include/commandes.h) permet de recevoir, à la place
+    des trames 0x1A5/0x1A6, une seule trame 0x1AB contenant les six données
+    à une résolution plus fine (0,1 °C, 0,1 %, 0,01 kPa) et un compteur de
+    séquence. Une donnée indisponible a tous les bits de son champ à 1. Le
+    découpage des bits est décrit dans include/protocole.h.
+
+Diagnostic :
+    Une requête sur l'ID 0x1A7 renvoie sur 0x1A8 le coût en cycles de chaque
+    étape du traitement (voir include/instrumentation.h), puis les compteurs
+    de trames, de requêtes, d'erreurs I2C, l'âge des mesures et le nombre
+    de passages dans loop() par seconde (voir include/statistiques.h).
+
+Commandes de configuration :
+    ID 0x1A9, réponse sur 0x1AA. Voir include/commandes.h pour la liste
+    des commandes (ex. réglage de R0 des capteurs de gaz).
+
+Configuration :
+    Le débit CAN, la base des identifiants, l'adresse et le profil de
+    mesure du BME280 (rapide, équilibré ou précis, voir
+    include/bme280_profils.h), les courbes des capteurs de gaz, les
+    fenêtres de fraîcheur, les seuils d'alarme, le format et la diffusion
+    sont lus en flash au démarrage, en une seule
+    lecture, avant l'initialisation du CAN. Les commandes 0x07 à 0x0A les
+    lisent, les modifient et les sauvegardent (voir include/configuration.h).
+
+Plusieurs cartes sur le bus :
+    Tous les identifiants ci-dessus sont ceux du nœud 0. Le numéro du nœud
+    (0 à 3) est lu au démarrage sur les broches PC0/PC1 (cavalier à la masse
+    = 1) ; le nœud n utilise le bloc 0x1A0 + 0x10 * n (base + 0x3 à
+    base + 0xF). La base 0x1A0 se change à la compilation avec -DCAN_ID_BASE
+    ou par la configuration.
+    Le filtre matériel du bxCAN n'accepte que le bloc de la carte et la
+    requête de groupe.
+
+Capteurs indisponibles :
+    Le nœud démarre sans attendre les capteurs. Un capteur absent ou muet
+    est réessayé en arrière-plan ; ses données valent 0xFF et une trame
+    d'état est envoyée sur l'ID 0x1AC (voir include/capteurs.h).
+
+Alarmes :
+    Des seuils par donnée (commandes 0x05/0x06) déclenchent l'envoi immédiat
+    d'une trame d'alarme sur l'ID prioritaire 0x0A0 (voir include/alarmes.h).
+
+Historique :
+    Les six données sont enregistrées toutes les 100 ms en RAM. Une requête
+    sur l'ID 0x1AD renvoie une plage de temps en rafale segmentée sur 0x1AE
+    (voir include/historique.h).
+
+Ordonnancement :
+    loop() exécute une tâche à la fois, par priorité fixe : alarmes,
+    service CAN, publications, historique, gaz, file I2C, SCD41, BME280,
+    transfert de l'historique, capteurs, diagnostic (voir
+    include/ordonnanceur.h). Lorsqu'aucune tâche n'est prête, le cœur dort
+    (WFI) jusqu'à la prochaine trame CAN ou au prochain tick de 1 ms
+    (voir include/sommeil.h).
+
+Requête « échantillonner tout » :
+    Une trame sur l'ID 0x19F, avec le même masque que la requête 0x1A4, est
+    servie par toutes les cartes : chacune répond sur ses propres ID, dans
+    un créneau de 2 ms décalé selon son numéro (voir include/adressage.h).
+
+Chien de garde :
+    L'IWDG redémarre la carte si loop() se bloque ou si le service CAN ne
+    suit plus. Un bus I2C bloqué est libéré sans redémarrage ; la cause du
+    démarrage et le nombre de récupérations sont envoyés sur l'ID 0x1AF
+    (voir include/sante.h et include/bus_i2c.h).
+
+Émission :
+    Les trames sont copiées dans une file par classe de priorité (alarmes,
+    réponses, diffusion, historique, diagnostic) que l'interruption
+    d'émission vide dans les boîtes libres du bxCAN (voir include/can_tx.h).
 */
 
 // Librairies
@@ -63,227 +146,423 @@ Remarques :
 #include <Wire.h>
 #include <stdint.h>
 #include "SparkFunBME280.h"
-#include "SparkFun_SCD4x_Arduino_Library.h"
 #include "STM32_CAN.h"
-#include <i2c_adc_ads7828.h>
 #include <iostream>
 #include <cstdint>
 #include <iomanip>
+#include "acquisition.h"
+#include "adressage.h"
+#include "alarmes.h"
+#include "bus_i2c.h"
+#include "cache_reponses.h"
+#include "capteurs.h"
+#include "can_rx.h"
+#include "can_tx.h"
+#include "commandes.h"
+#include "configuration.h"
+#include "conversion_gaz.h"
+#include "diffusion.h"
+#include "historique.h"
+#include "instrumentation.h"
+#include "ordonnanceur.h"
+#include "protocole.h"
+#include "sante.h"
+#include "statistiques.h"
+#include "scd41.h"
+#include "sommeil.h"
 
 // Définition de la broche de la LED de statut
 #define LED_PIN PC12
 
-// Définition pour le MQ4 et le MQ7
-#define m -0.318
-#define b 1.133
-#define R0 5.5
+// Tâches de main.cpp : retards tolérés et période des publications (ms)
+#define DELAI_ALARMES_MS 1
+#define DELAI_CAN_MS 1
+#define PERIODE_PUBLICATION_MS 1 // créneau de groupe et mode diffusion
+#define DELAI_PUBLICATION_MS 1
+#define DELAI_DIAGNOSTIC_MS 50
+#define DELAI_ENREGISTREMENT_MS 10
+#define PERIODE_HISTORIQUE_MS 1 // HISTORIQUE_TRAMES_PAR_MS trames par exécution
+#define DELAI_HISTORIQUE_MS 5
+#define PERIODE_CAPTEURS_MS 100 // surveillance et réessai des capteurs
+#define DELAI_CAPTEURS_MS 20    // beginI2C() du BME280 lit ses coefficients
+
+// Initialisation du bus I2C avec des broches spécifiques
+TwoWire myWire(BUS_I2C_SDA, BUS_I2C_SCL);
+
+// Déclaration des objets pour les capteurs numériques
+BME280 BME280_Sensor;
+
+// Configuration CAN sur le STM32
+STM32_CAN Can(CAN1, DEF); // PA11/12 pins pour CAN1
+static CAN_message_t CAN_RX_msg;
+static CAN_message_t CAN_TX_msg;
 
 /*
- * Fonction : encoder_float_entier
- * But : Convertit un float en un uint8_t en gardant uniquement la partie entière
- * Paramètres :
- *    - valeur : la valeur flottante à convertir
- *    - memoire : tableau dans lequel stocker l'octet résultant
- *    - index : position actuelle dans le tableau (sera automatiquement incrémentée)
+ * Fonction : lire_trame
+ * But : Retire une trame du tampon de réception en mesurant son coût
  */
-void encoder_float_entier(float valeur, uint8_t *memoire, size_t &index)
+bool lire_trame(CAN_message_t &trame)
 {
-    uint8_t entier = static_cast<uint8_t>(valeur); // partie entière seulement
-    memoire[index++] = entier;
+    MesureCycles mesure(POINT_CAN_RX);
+    return can_rx_lire(trame);
 }
 
 /*
- * Fonction : encoder_uint16
- * But : Encode un entier 16 bits (uint16_t) en deux octets (MSB + LSB)
- * Paramètres :
- *    - valeur : la valeur entière 16 bits à convertir
- *    - memoire : tableau dans lequel stocker les deux octets
- *    - index : position actuelle dans le tableau (sera automatiquement incrémentée de 2)
+ * Fonction : ecrire_trame
+ * But : Place une trame dans la file d'émission de sa priorité en mesurant
+ *       le coût de la mise en file (la trame peut être réutilisée au retour)
+ * Retour :
+ *    - false si la file d'émission est pleine
  */
-void encoder_uint16(uint16_t valeur, uint8_t *memoire, size_t &index)
+bool ecrire_trame(const CAN_message_t &trame, PrioriteTx priorite)
 {
-    memoire[index++] = static_cast<uint8_t>(valeur >> 8);   // octet haut (MSB)
-    memoire[index++] = static_cast<uint8_t>(valeur & 0xFF); // octet bas (LSB)
+    MesureCycles mesure(POINT_CAN_TX);
+    return can_tx_envoyer(trame, priorite);
 }
 
 /*
- * Fonction : computePPM
- * But : Calcule une concentration en ppm à partir d'une lecture brute du capteur analogique
+ * Fonction : envoyer_donnees
+ * But : Encode les données désignées par le masque et envoie les trames 0x1A5/0x1A6
  * Paramètres :
- *    - sensorValue : valeur analogique brute du capteur (généralement entre 0 et 1023)
- * Retour :
- *    - La concentration estimée en ppm sous forme d'un entier 16 bits non signé (uint16_t)
+ *    - masque : un octet 0x11 par donnée désirée
+ *    - longueur : nombre d'octets du masque
+ *    - priorite : réponse à une requête ou publication
  */
-uint16_t computePPM(float sensorValue)
+void envoyer_donnees(const uint8_t *masque, size_t longueur, PrioriteTx priorite)
 {
-    float voltage = sensorValue * (5.0 / 1023.0);
-    float RS_gas = ((5.0 * 1.0) / voltage) - 1.0;
-    float ratio = RS_gas / R0;
-    float ppm_log = (log10(ratio) - b) / m;
-    float ppm = pow(10, ppm_log);
-
-    if (ppm < 0.0)
-        return 0;
-    if (ppm > 65535.0)
-        return 65535;
-
-    return static_cast<uint16_t>(ppm + 0.5);
-}
+    // Format compact : toutes les données dans une seule trame, le masque est ignoré
+    if (commande_format() == FORMAT_COMPACT)
+    {
+        static uint8_t sequence = 0;
+        CAN_TX_msg.id = adressage_id(CAN_DECALAGE_REPONSE_COMPACTE);
+        CAN_TX_msg.len = 8;
+        {
+            MesureCycles mesure(POINT_ENCODAGE);
+            encoder_compact(acquisition_mesures(), capteurs_donnees_disponibles(), sequence++, CAN_TX_msg.buf);
+        }
+        ecrire_trame(CAN_TX_msg, priorite);
+        return;
+    }
 
-// Initialisation du bus I2C avec des broches spécifiques
-TwoWire myWire(PB7, PB6);
+    // Les valeurs proviennent du cache : aucune lecture I2C ici. Les trames sont
+    // des modèles déjà encodés, mis à jour seulement pour les données modifiées
+    CAN_message_t *trames[2];
+    uint8_t nb_trames;
+    {
+        MesureCycles mesure(POINT_ENCODAGE);
+        nb_trames = cache_reponse(masque, longueur, millis(), trames);
+    }
 
-// Configuration des canaux ADC pour les capteurs analogiques
-ADS7828 device(3, SINGLE_ENDED | REFERENCE_ON | ADC_ON, 0x0F);
-ADS7828 *adc = &device;
-ADS7828Channel *MQ7 = adc->channel(0);     // Capteur de CO
-ADS7828Channel *SEN_094 = adc->channel(1); // Capteur de méthane
+    // Trame 0x1A5, puis 0x1A6 uniquement si la pression est demandée
+    for (uint8_t i = 0; i < nb_trames; i++)
+    {
+        ecrire_trame(*trames[i], priorite);
+    }
+}
 
-// Déclaration des objets pour les capteurs numériques
-SCD4x SCD41_Sensor;
-BME280 BME280_Sensor;
+/*
+ * Fonction : repondre_commande
+ * But : Exécute une commande reçue sur 0x1A9 et envoie sa réponse sur 0x1AA
+ */
+void repondre_commande(const CAN_message_t &commande, uint32_t maintenant)
+{
+    uint8_t longueur = commande_traiter(commande.buf, commande.len, CAN_TX_msg.buf, maintenant);
+    if (longueur > 0)
+    {
+        CAN_TX_msg.id = adressage_id(CAN_DECALAGE_COMMANDE_REPONSE);
+        CAN_TX_msg.len = longueur;
+        ecrire_trame(CAN_TX_msg, PRIORITE_REPONSE);
+    }
+}
 
-// Configuration CAN sur le STM32
-STM32_CAN Can(CAN1, DEF); // PA11/12 pins pour CAN1
-static CAN_message_t CAN_RX_msg;
-static CAN_message_t CAN_TX_msg;
+// Trames de diagnostic restant à envoyer (une par exécution de la tâche)
+static uint8_t trame_diagnostic = 0;
+static uint8_t trames_diagnostic_restantes = 0;
 
-void setup()
-{
-    pinMode(LED_PIN, OUTPUT); // LED pour le statut système
-    digitalWrite(LED_PIN,LOW);
+/*
+ * Fonction : repondre_diagnostic
+ * But : Planifie l'envoi des statistiques sur 0x1A8, ou les remet à zéro
+ */
+void repondre_diagnostic(const CAN_message_t &requete);
 
-    // Initialisation du CAN à 500 kbps
-    Can.begin();
-    Can.setBaudRate(500000);
+static void envoyer_diagnostic(uint32_t maintenant);
 
-    // Initialisation du bus I2C
-    myWire.begin();
+/*
+ * Fonction : servir_can
+ * But : Traite toutes les trames reçues par interruption depuis la dernière exécution
+ */
+static void servir_can(uint32_t maintenant)
+{
+    sante_service_can(maintenant);
 
-    // Démarrage du capteur CO2 SCD41
-    if (SCD41_Sensor.begin(myWire) == false)
+    while (lire_trame(CAN_RX_msg))
     {
-        while (1)
+        // Requête commune à tous les nœuds : réponse différée au créneau du nœud
+        if (CAN_RX_msg.id == adressage_groupe())
+        {
+            adressage_requete_groupe(CAN_RX_msg.buf, CAN_RX_msg.len, micros());
+            statistiques_requete_groupe();
+            continue;
+        }
+
+        switch (CAN_RX_msg.id - adressage_base())
         {
-            // Possibilité : envoyer un message CAN d’erreur si init échoue
+        case CAN_DECALAGE_REQUETE:
+            envoyer_donnees(CAN_RX_msg.buf, CAN_RX_msg.len, PRIORITE_REPONSE);
+            statistiques_requete(CAN_RX_msg.timestamp, millis());
+            break;
+        case CAN_DECALAGE_CONFIG_DIFFUSION:
+            diffusion_configurer(CAN_RX_msg.buf, CAN_RX_msg.len, maintenant);
+            break;
+        case CAN_DECALAGE_COMMANDE:
+            repondre_commande(CAN_RX_msg, maintenant);
+            break;
+        case CAN_DECALAGE_DIAGNOSTIC:
+            repondre_diagnostic(CAN_RX_msg);
+            break;
+        case CAN_DECALAGE_HISTORIQUE:
+            historique_demander(CAN_RX_msg.buf, CAN_RX_msg.len, maintenant);
+            break;
+        default:
+            statistiques_ignoree();
+            break;
         }
     }
+}
 
+/*
+ * Fonction : envoyer_alarmes
+ * But : Envoie les changements d'état des alarmes sur l'identifiant prioritaire du nœud
+ */
+static void envoyer_alarmes(uint32_t)
+{
+    static CAN_message_t trame_alarme;
+    trame_alarme.id = CAN_ID_ALARME_BASE + adressage_noeud();
+    trame_alarme.len = ALARMES_TAILLE_TRAME;
 
-    // Démarrage du capteur BME280 (pression/température/humidité)
-    BME280_Sensor.setI2CAddress(0x77);
-    if (BME280_Sensor.beginI2C(myWire) == false)
+    // Si la file d'émission est pleine, le changement est repris au prochain passage
+    while (alarmes_trame(trame_alarme.buf) && ecrire_trame(trame_alarme, PRIORITE_ALARME))
     {
-        while (1)
-        {
-            // Possibilité : envoyer un message CAN d’erreur si init échoue
-        }
+        alarmes_envoyee(trame_alarme.buf[0]);
+    }
+}
+
+/*
+ * Fonction : publier
+ * But : Réponse de groupe au créneau du nœud et publication du mode diffusion
+ */
+static void publier(uint32_t maintenant)
+{
+    uint8_t masque_groupe[NB_DONNEES];
+    size_t longueur_groupe;
+    if (adressage_creneau(micros(), masque_groupe, longueur_groupe))
+    {
+        envoyer_donnees(masque_groupe, longueur_groupe, PRIORITE_DIFFUSION);
+    }
+
+    if (diffusion_echeance(maintenant))
+    {
+        envoyer_donnees(diffusion_masque(), NB_DONNEES, PRIORITE_DIFFUSION);
     }
+}
+
+/*
+ * Fonction : surveiller_capteurs
+ * But : Réessaie les capteurs indisponibles et envoie les trames d'état et de santé
+ */
+static void surveiller_capteurs(uint32_t maintenant)
+{
+    capteurs_surveiller(maintenant);
+
+    if (capteurs_etat_a_publier(maintenant))
+    {
+        CAN_TX_msg.id = adressage_id(CAN_DECALAGE_ETAT);
+        CAN_TX_msg.len = CAPTEURS_TAILLE_ETAT;
+        capteurs_trame_etat(CAN_TX_msg.buf);
+        ecrire_trame(CAN_TX_msg, PRIORITE_DIFFUSION);
+    }
+
+    if (sante_a_publier())
+    {
+        CAN_TX_msg.id = adressage_id(CAN_DECALAGE_SANTE);
+        CAN_TX_msg.len = SANTE_TAILLE_TRAME;
+        sante_trame(CAN_TX_msg.buf);
+        ecrire_trame(CAN_TX_msg, PRIORITE_DIFFUSION);
+    }
+}
+
+/*
+ * Fonction : transferer_historique
+ * But : Envoie les trames suivantes du transfert d'historique, à débit limité
+ */
+static void transferer_historique(uint32_t)
+{
+    static CAN_message_t trame_historique;
+    trame_historique.id = adressage_id(CAN_DECALAGE_HISTORIQUE_REPONSE);
+    trame_historique.len = 8;
+
+    // Si la file d'émission est pleine, la même trame est reprise au prochain passage
+    for (int i = 0; i < HISTORIQUE_TRAMES_PAR_MS && historique_trame(trame_historique.buf); i++)
+    {
+        if (!ecrire_trame(trame_historique, PRIORITE_HISTORIQUE))
+            break;
+        historique_avancer();
+    }
+}
 
+static bool diagnostic_en_attente()
+{
+    return trames_diagnostic_restantes != 0;
+}
 
-    // Ajustement de l’échelle de mesure des capteurs analogiques
-    MQ7->minScale = 0;
-    MQ7->maxScale = 4095;
-    SEN_094->minScale = 0;
-    SEN_094->maxScale = 4095;
+// Tâches de main.cpp ; les tâches des capteurs sont dans acquisition.cpp
+static Tache tache_can = {servir_can, can_rx_en_attente, 0, DELAI_CAN_MS};
+static Tache tache_alarmes = {envoyer_alarmes, alarmes_en_attente, 0, DELAI_ALARMES_MS};
+static Tache tache_publication = {publier, nullptr, PERIODE_PUBLICATION_MS, DELAI_PUBLICATION_MS};
+static Tache tache_enregistrement = {historique_ajouter, nullptr, HISTORIQUE_PERIODE_MS, DELAI_ENREGISTREMENT_MS};
+static Tache tache_historique = {transferer_historique, nullptr, PERIODE_HISTORIQUE_MS, DELAI_HISTORIQUE_MS};
+static Tache tache_capteurs = {surveiller_capteurs, nullptr, PERIODE_CAPTEURS_MS, DELAI_CAPTEURS_MS};
+static Tache tache_diagnostic = {envoyer_diagnostic, diagnostic_en_attente, 0, DELAI_DIAGNOSTIC_MS};
+
+// Ordre de priorité : alarmes, service CAN, publications, enregistrement de
+// l'historique, échantillonnage des gaz, file I2C, capteurs lents, transfert
+// de l'historique, surveillance des capteurs, puis diagnostic
+static Tache *const taches[] = {
+    &tache_alarmes,
+    &tache_can,
+    &tache_publication,
+    &tache_enregistrement,
+    &acquisition_tache(TACHE_GAZ),
+    &acquisition_tache(TACHE_I2C),
+    &acquisition_tache(TACHE_SCD41),
+    &acquisition_tache(TACHE_BME280),
+    &tache_historique,
+    &tache_capteurs,
+    &tache_diagnostic,
+};
+static const size_t nb_taches = sizeof(taches) / sizeof(taches[0]);
 
+/*
+ * Fonction : envoyer_diagnostic
+ * But : Envoie la trame de diagnostic suivante : étapes instrumentées,
+ *       compteurs de chaque tâche, puis statistiques. Une trame par
+ *       exécution pour ne pas retarder le service CAN
+ */
+static void envoyer_diagnostic(uint32_t maintenant)
+{
+    CAN_TX_msg.id = adressage_id(CAN_DECALAGE_DIAGNOSTIC_REPONSE);
+    CAN_TX_msg.len = 8;
+    if (trame_diagnostic < DIAG_NB_TRAMES)
+    {
+        instrumentation_trame(trame_diagnostic, CAN_TX_msg.buf);
+    }
+    else if (trame_diagnostic < DIAG_NB_TRAMES + nb_taches)
+    {
+        uint8_t tache = trame_diagnostic - DIAG_NB_TRAMES;
+        instrumentation_trame_compteurs(DIAG_ETIQUETTE_TACHE + tache, taches[tache]->manquees,
+                                        taches[tache]->executions, CAN_TX_msg.buf);
+    }
+    else
+    {
+        statistiques_trame(trame_diagnostic - DIAG_NB_TRAMES - nb_taches, maintenant, CAN_TX_msg.buf);
+    }
+
+    // File d'émission pleine (une réponse complète dépasse sa capacité) :
+    // la même trame est reprise à la prochaine exécution
+    if (!ecrire_trame(CAN_TX_msg, PRIORITE_DIAGNOSTIC))
+        return;
 
+    trame_diagnostic++;
+    trames_diagnostic_restantes--;
+}
+
+void repondre_diagnostic(const CAN_message_t &requete)
+{
+    if (requete.len > 0 && requete.buf[0] == DIAG_REMETTRE_A_ZERO)
+    {
+        instrumentation_remettre_a_zero();
+        ordonnanceur_remettre_a_zero(taches, nb_taches);
+        return;
+    }
+
+    // Statistiques seules : dernières trames de la réponse complète
+    if (requete.len > 0 && requete.buf[0] == DIAG_STATISTIQUES)
+    {
+        trame_diagnostic = DIAG_NB_TRAMES + nb_taches;
+        trames_diagnostic_restantes = STATISTIQUES_NB_TRAMES;
+        return;
+    }
+
+    trame_diagnostic = 0;
+    trames_diagnostic_restantes = DIAG_NB_TRAMES + nb_taches + STATISTIQUES_NB_TRAMES;
+}
+
+void setup()
+{
+    pinMode(LED_PIN, OUTPUT); // LED pour le statut système
+    digitalWrite(LED_PIN,LOW);
+
+    // Configuration sauvegardée (ou valeurs par défaut), nécessaire avant le CAN
+    const Configuration &config = configuration_charger();
+
+    // Initialisation du CAN au débit configuré (500 kbps par défaut)
+    Can.begin();
+    Can.setBaudRate(config.debit_can);
+
+    // Numéro du nœud lu sur les broches de configuration
+    adressage_init(config.base_can);
+
+    // Seuls le bloc d'identifiants du nœud et la requête de groupe atteignent
+    // la FIFO, puis réception par interruption vers un tampon circulaire
+    can_rx_filtrer(Can, adressage_base(), CAN_MASQUE_BLOC);
+    can_rx_filtrer(Can, adressage_groupe(), 0x7FF);
+    can_rx_init();
+
+    // Émission par files de priorité vidées par interruption
+    can_tx_init();
+
+    // Compteur de cycles pour l'instrumentation
+    cycles_init();
+
+    // Initialisation du bus I2C en Fast Mode (400 kHz)
+    bus_i2c_init(myWire);
+
+    // Capteurs initialisés en arrière-plan par la tâche de surveillance :
+    // un capteur absent ne bloque plus le démarrage (voir include/capteurs.h)
+    capteurs_init(millis());
+
+    // Tables de conversion des gaz, fenêtres, seuils et diffusion configurés
+    configuration_appliquer(millis());
+
+#ifdef BANC_ESSAI_CONVERSION
+    Serial.begin(9600);
+    conversion_banc_essai(Serial);
+#endif
+
+    // Chien de garde démarré une fois les initialisations longues terminées
+    sante_init();
+
+    // Les lectures des capteurs sont confiées à l'ordonnanceur
+    ordonnanceur_init(taches, nb_taches, millis());
 }
 
 void loop()
 {
-    // Vérifie si un message CAN a été reçu
-    if (Can.read(CAN_RX_msg))
+    // Exécute une tâche à la fois, la plus prioritaire d'abord
+    bool executee;
     {
-        // Vérifie que le message est bien destiné à ce module (ID 0x1A4 attendu)
-        if (CAN_RX_msg.id == 0x1A4)
-        {
+        MesureCycles mesure_boucle(POINT_BOUCLE);
+        executee = ordonnanceur_executer(taches, nb_taches, millis());
+    }
 
-            // Tableau pour stocker les données encodées (jusqu’à 9 octets)
-            uint8_t donnees[9] = {0};
-            size_t index = 0;
-
-            // Parcours des octets de la trame CAN reçue
-            for (int i = 0; i < CAN_RX_msg.len; i++)
-            {
-                // Si l'utilisateur a mis 0x11 pour cette donnée, on lit et encode
-                if (CAN_RX_msg.buf[i] == 0x11)
-                {
-                    switch (i)
-                    {
-                    case 0:
-                    {
-                        uint16_t ch4 = computePPM(SEN_094->value());
-                        encoder_uint16(ch4, donnees, index);
-                        break;
-                    }
-                    case 1:
-                    {
-                        uint16_t co2 = SCD41_Sensor.getCO2();
-                        encoder_uint16(co2, donnees, index);
-                        break;
-                    }
-                    case 2:
-                    {
-                        uint16_t co = computePPM(MQ7->value());
-                        encoder_uint16(co, donnees, index);
-                        break;
-                    }
-                    case 3:
-                    {
-                        float temp = (BME280_Sensor.readTempC() + SCD41_Sensor.getTemperature()) / 2;
-                        encoder_float_entier(temp, donnees, index);
-                        break;
-                    }
-                    case 4:
-                    {
-                        float hum = (BME280_Sensor.readFloatHumidity() + SCD41_Sensor.getHumidity()) / 2;
-                        encoder_float_entier(hum, donnees, index);
-                        break;
-                    }
-                    case 5:
-                    {
-                        float press_pa = BME280_Sensor.readFloatPressure();
-                        float press_kpa = press_pa / 1000.0f;
-                        encoder_float_entier(press_kpa, donnees, index);
-                        break;
-                    }
-                    default:
-                        break;
-                    }
-                }
-                else
-                {
-                    // Si la donnée n'est pas demandée, on remplit le bon nombre d'octets avec 0xFF
-                    if (i <= 2 && index + 1 < sizeof(donnees))
-                    {
-                        donnees[index++] = 0xFF;
-                        donnees[index++] = 0xFF;
-                    }
-                    else if (index < sizeof(donnees))
-                    {
-                        donnees[index++] = 0xFF;
-                    }
-                }
-            }
-
-            // Envoi de la première trame (0x1A5) : jusqu’à 8 octets
-            CAN_TX_msg.id = 0x1A5;
-            CAN_TX_msg.len = 8;
-            for (int j = 0; j < 8; j++)
-            {
-                CAN_TX_msg.buf[j] = donnees[j];
-            }
-            Can.write(CAN_TX_msg);
-
-            // Envoi de la deuxième trame (0x1A6) uniquement si la pression a été encodée
-            if (donnees[8] != 0)
-            {
-                CAN_TX_msg.id = 0x1A6;
-                CAN_TX_msg.len = 1;
-                CAN_TX_msg.buf[0] = donnees[8];
-                Can.write(CAN_TX_msg);
-            }
-        }
+    statistiques_boucle(millis());
+
+    // Rechargé seulement si la boucle tourne et que le service CAN suit
+    sante_rafraichir(millis());
+
+    // Aucune tâche prête : veille jusqu'à la prochaine trame ou au prochain tick
+    if (!executee)
+    {
+        sommeil_attendre();
     }
-}
\ No newline at end of file
+}
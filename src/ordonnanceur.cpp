@@ -0,0 +1,76 @@
+#include "ordonnanceur.h"
+
+/*
+ * Fonction : tache_prete
+ * But : Indique si une tâche doit s'exécuter et mémorise l'instant de son activation
+ */
+static bool tache_prete(Tache &tache, uint32_t maintenant)
+{
+    if (tache.periode_ms != 0)
+    {
+        // Comparaison signée pour rester valide au débordement de millis()
+        return static_cast<int32_t>(maintenant - tache.echeance) >= 0;
+    }
+
+    if (!tache.prete())
+        return false;
+
+    if (!tache.en_attente)
+    {
+        tache.en_attente = true;
+        tache.echeance = maintenant;
+    }
+    return true;
+}
+
+void ordonnanceur_init(Tache *const *taches, size_t nb, uint32_t maintenant)
+{
+    for (size_t i = 0; i < nb; i++)
+    {
+        taches[i]->echeance = maintenant + taches[i]->periode_ms;
+        taches[i]->en_attente = false;
+    }
+}
+
+bool ordonnanceur_executer(Tache *const *taches, size_t nb, uint32_t maintenant)
+{
+    for (size_t i = 0; i < nb; i++)
+    {
+        Tache &tache = *taches[i];
+        if (!tache_prete(tache, maintenant))
+            continue;
+
+        if (maintenant - tache.echeance > tache.delai_ms)
+            tache.manquees++;
+        tache.executions++;
+
+        if (tache.periode_ms != 0)
+        {
+            tache.echeance += tache.periode_ms;
+
+            // Après un long retard, on repart de maintenant plutôt que de rattraper
+            if (static_cast<int32_t>(maintenant - tache.echeance) >= 0)
+                tache.echeance = maintenant + tache.periode_ms;
+        }
+        tache.en_attente = false;
+
+        tache.executer(maintenant);
+        return true;
+    }
+    return false;
+}
+
+void ordonnanceur_avancer(Tache &tache, uint32_t maintenant)
+{
+    if (tache.periode_ms != 0)
+        tache.echeance = maintenant;
+}
+
+void ordonnanceur_remettre_a_zero(Tache *const *taches, size_t nb)
+{
+    for (size_t i = 0; i < nb; i++)
+    {
+        taches[i]->executions = 0;
+        taches[i]->manquees = 0;
+    }
+}
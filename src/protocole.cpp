@@ -0,0 +1,96 @@
+#include "protocole.h"
+
+void encoder_float_entier(float valeur, uint8_t *memoire, size_t &index)
+{
+    uint8_t entier = static_cast<uint8_t>(valeur); // partie entière seulement
+    memoire[index++] = entier;
+}
+
+void encoder_uint16(uint16_t valeur, uint8_t *memoire, size_t &index)
+{
+    memoire[index++] = static_cast<uint8_t>(valeur & 0xFF); // octet bas (LSB)
+    memoire[index++] = static_cast<uint8_t>(valeur >> 8);   // octet haut (MSB)
+}
+
+void encoder_donnee(const Mesures &mesures, Donnee donnee, uint8_t donnees[TAILLE_DONNEES])
+{
+    if (donnee >= NB_DONNEES)
+        return;
+
+    size_t index = position_donnee(donnee);
+    table_donnees[donnee].encoder(mesures, donnees, index);
+}
+
+uint8_t decoder_masque(const uint8_t *masque, size_t longueur)
+{
+    uint8_t demandees = 0;
+    for (size_t i = 0; i < longueur && i < NB_DONNEES; i++)
+    {
+        demandees |= static_cast<uint8_t>((masque[i] == DONNEE_DEMANDEE) << i);
+    }
+    return demandees;
+}
+
+void encoder_donnees(const Mesures &mesures, const uint8_t *masque, size_t longueur,
+                     uint8_t donnees[TAILLE_DONNEES])
+{
+    for (size_t i = 0; i < TAILLE_DONNEES; i++)
+    {
+        donnees[i] = 0;
+    }
+
+    // Parcours des octets du masque
+    for (size_t i = 0; i < longueur && i < NB_DONNEES; i++)
+    {
+        Donnee donnee = static_cast<Donnee>(i);
+
+        // Si l'utilisateur a mis 0x11 pour cette donnée, on encode
+        if (masque[i] == DONNEE_DEMANDEE)
+        {
+            encoder_donnee(mesures, donnee, donnees);
+        }
+        else
+        {
+            // Si la donnée n'est pas demandée, on remplit le bon nombre d'octets avec 0xFF
+            for (size_t j = 0; j < taille_donnee(donnee); j++)
+            {
+                donnees[position_donnee(donnee) + j] = 0xFF;
+            }
+        }
+    }
+}
+
+/*
+ * Fonction : champ
+ * But : Quantifie une valeur (valeur - origine) / pas, saturée sous la
+ *       valeur « indisponible » (tous les bits à 1)
+ */
+static uint64_t champ(float valeur, float origine, float pas, uint8_t nb_bits)
+{
+    float quantifie = (valeur - origine) / pas + 0.5f;
+    uint32_t maximum = (1UL << nb_bits) - 2;
+    if (!(quantifie > 0.0f))
+        return 0;
+    if (quantifie >= static_cast<float>(maximum))
+        return maximum;
+    return static_cast<uint64_t>(quantifie);
+}
+
+void encoder_compact(const Mesures &mesures, uint8_t disponibles, uint8_t sequence, uint8_t donnees[8])
+{
+    uint64_t trame = static_cast<uint64_t>(sequence & 0x07);
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        const DescripteurDonnee &descripteur = table_donnees[i];
+        const ChampCompact &compact = descripteur.compact;
+        uint64_t valeur = (disponibles & (1u << i))
+                              ? champ(descripteur.lire(mesures), compact.origine, compact.pas, compact.bits)
+                              : (1ULL << compact.bits) - 1;
+        trame |= valeur << decalage_compact(static_cast<Donnee>(i));
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        donnees[i] = static_cast<uint8_t>(trame >> (8 * i));
+    }
+}
@@ -0,0 +1,107 @@
+#include "sante.h"
+
+#include <Arduino.h>
+#include "bus_i2c.h"
+#include "can_rx.h"
+
+// Clés du registre IWDG_KR
+#define IWDG_CLE_DEMARRER 0xCCCC
+#define IWDG_CLE_ACCES 0x5555
+#define IWDG_CLE_RECHARGER 0xAAAA
+
+// LSI / 64 : une unité de rechargement toutes les 2 ms
+#define IWDG_PREDIVISEUR_64 4
+#define IWDG_MS_PAR_UNITE 2
+
+static uint8_t cause_demarrage = 0;
+static uint16_t redemarrages_chien_de_garde = 0;
+static uint32_t dernier_service_can = 0;
+static uint32_t recuperations_publiees = 0;
+static bool demarrage_publie = false;
+
+static uint16_t saturer(uint32_t valeur)
+{
+    return valeur > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(valeur);
+}
+
+/*
+ * Fonction : compter_redemarrages
+ * But : Tient le compteur de redémarrages par le chien de garde dans le
+ *       registre de sauvegarde RTC_BKP0R, conservé tant que la carte reste alimentée
+ */
+static void compter_redemarrages(uint8_t cause)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR |= PWR_CR_DBP;
+
+    uint32_t compteur = RTC->BKP0R;
+    if (cause & SANTE_DEMARRAGE_ALIMENTATION)
+        compteur = 0;
+    else if (cause & SANTE_DEMARRAGE_CHIEN_DE_GARDE)
+        compteur++;
+    RTC->BKP0R = compteur;
+    redemarrages_chien_de_garde = saturer(compteur);
+}
+
+void sante_init()
+{
+    uint32_t csr = RCC->CSR;
+    if (csr & RCC_CSR_IWDGRSTF)
+        cause_demarrage |= SANTE_DEMARRAGE_CHIEN_DE_GARDE;
+    if (csr & RCC_CSR_SFTRSTF)
+        cause_demarrage |= SANTE_DEMARRAGE_LOGICIEL;
+    if (csr & RCC_CSR_PINRSTF)
+        cause_demarrage |= SANTE_DEMARRAGE_BROCHE;
+    if (csr & (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF))
+        cause_demarrage |= SANTE_DEMARRAGE_ALIMENTATION;
+    RCC->CSR |= RCC_CSR_RMVF;
+
+    compter_redemarrages(cause_demarrage);
+
+    IWDG->KR = IWDG_CLE_DEMARRER;
+    IWDG->KR = IWDG_CLE_ACCES;
+    IWDG->PR = IWDG_PREDIVISEUR_64;
+    IWDG->RLR = SANTE_IWDG_DELAI_MS / IWDG_MS_PAR_UNITE;
+    while (IWDG->SR != 0)
+    {
+    }
+    IWDG->KR = IWDG_CLE_RECHARGER;
+
+    dernier_service_can = millis();
+}
+
+void sante_service_can(uint32_t maintenant)
+{
+    dernier_service_can = maintenant;
+}
+
+void sante_rafraichir(uint32_t maintenant)
+{
+    // Trames en attente sans service récent : le chien de garde n'est pas rechargé
+    if (can_rx_en_attente() && maintenant - dernier_service_can > SANTE_DELAI_CAN_MS)
+        return;
+
+    IWDG->KR = IWDG_CLE_RECHARGER;
+}
+
+bool sante_a_publier()
+{
+    return !demarrage_publie || bus_i2c_recuperations() != recuperations_publiees;
+}
+
+void sante_trame(uint8_t donnees[8])
+{
+    demarrage_publie = true;
+    recuperations_publiees = bus_i2c_recuperations();
+
+    uint16_t recuperations = saturer(recuperations_publiees);
+    uint16_t erreurs = saturer(bus_i2c_erreurs());
+
+    donnees[0] = cause_demarrage;
+    donnees[1] = static_cast<uint8_t>(recuperations & 0xFF);
+    donnees[2] = static_cast<uint8_t>(recuperations >> 8);
+    donnees[3] = static_cast<uint8_t>(erreurs & 0xFF);
+    donnees[4] = static_cast<uint8_t>(erreurs >> 8);
+    donnees[5] = static_cast<uint8_t>(redemarrages_chien_de_garde & 0xFF);
+    donnees[6] = static_cast<uint8_t>(redemarrages_chien_de_garde >> 8);
+}
@@ -0,0 +1,255 @@
+#include "scd41.h"
+
+#include "bus_i2c.h"
+
+// Commandes Sensirion utilisées
+#define SCD41_CMD_ARRETER 0x3F86
+#define SCD41_CMD_REINITIALISER 0x3646
+#define SCD41_CMD_NUMERO_SERIE 0x3682
+#define SCD41_CMD_DEMARRER 0x21B1
+#define SCD41_CMD_DEMARRER_BASSE_CONSOMMATION 0x21AC
+#define SCD41_CMD_DONNEE_PRETE 0xE4B8
+#define SCD41_CMD_LIRE_MESURE 0xEC05
+
+// Délai d'exécution d'une commande avant de lire la réponse (ms)
+// 2 ms avec millis() garantissent au moins la 1 ms exigée par la fiche technique
+#define SCD41_DELAI_COMMANDE_MS 2
+
+// Délais de la fiche technique après l'arrêt de la mesure et la réinitialisation (ms)
+#define SCD41_DELAI_ARRET_MS 500
+#define SCD41_DELAI_REINITIALISATION_MS 30
+
+enum EtatScd41
+{
+    INACTIF,         // pas démarré, ou démarrage en échec
+    ARRETER,         // arrêt d'une mesure périodique éventuellement en cours
+    REINITIALISER,   // rechargement des réglages de l'EEPROM du capteur
+    NUMERO_SERIE,    // commande « numéro de série » à envoyer (vérifie le capteur)
+    LIRE_SERIE,      // commande envoyée, réponse à lire
+    DEMARRER,        // démarrage de la mesure périodique
+    ATTENTE,         // attend la prochaine vérification
+    LIRE_PRETE,      // commande « donnée prête » envoyée, réponse à lire
+    ENVOYER_LECTURE, // donnée prête, commande « lire mesure » à envoyer
+    LIRE_MESURE,     // commande « lire mesure » envoyée, réponse à lire
+    EN_COURS,        // transaction soumise, en attente de sa fin
+};
+
+static EtatScd41 etat = INACTIF;
+static bool basse_consommation_demandee = false;
+static bool en_defaut = false;
+
+// Incrémenté à chaque démarrage : la fin d'une transaction soumise avant
+// un redémarrage est ignorée
+static uint8_t generation = 0;
+static bool nouvelle_mesure = false;
+static uint32_t echeance = 0;
+static Scd41Mesure mesure = {};
+
+/*
+ * Fonction : crc8
+ * But : Somme de contrôle Sensirion (polynôme 0x31, valeur initiale 0xFF)
+ */
+static uint8_t crc8(const uint8_t *donnees, uint8_t longueur)
+{
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < longueur; i++)
+    {
+        crc ^= donnees[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x31) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*
+ * Fonction : decoder_mots
+ * But : Décode une réponse de plusieurs mots de 16 bits suivis chacun de leur CRC
+ * Retour :
+ *    - false si un CRC est invalide
+ */
+static bool decoder_mots(const uint8_t *octets, uint16_t *mots, uint8_t nb_mots)
+{
+    for (uint8_t i = 0; i < nb_mots; i++)
+    {
+        const uint8_t *mot = &octets[3 * i];
+        if (crc8(mot, 2) != mot[2])
+            return false;
+        mots[i] = static_cast<uint16_t>((mot[0] << 8) | mot[1]);
+    }
+    return true;
+}
+
+static void planifier(EtatScd41 suivant, uint32_t delai_ms)
+{
+    etat = suivant;
+    echeance = millis() + delai_ms;
+}
+
+/*
+ * Fonction : fin_etape
+ * But : Fonction de rappel de la file I2C ; le contexte est l'état ayant soumis
+ *       la transaction (octet de poids faible) et la génération du démarrage
+ */
+static void fin_etape(const uint8_t *lecture, bool reussie, uint32_t contexte_generation)
+{
+    if ((contexte_generation >> 8) != generation)
+        return;
+    uint32_t contexte = contexte_generation & 0xFF;
+
+    // Échec pendant le démarrage : le capteur est signalé en défaut
+    if (contexte < ATTENTE && !reussie)
+    {
+        etat = INACTIF;
+        en_defaut = true;
+        return;
+    }
+
+    if (!reussie)
+    {
+        planifier(ATTENTE, SCD41_PERIODE_VERIFICATION_MS);
+        return;
+    }
+
+    switch (contexte)
+    {
+    case ARRETER:
+        planifier(REINITIALISER, SCD41_DELAI_ARRET_MS);
+        break;
+    case REINITIALISER:
+        planifier(NUMERO_SERIE, SCD41_DELAI_REINITIALISATION_MS);
+        break;
+    case NUMERO_SERIE:
+        planifier(LIRE_SERIE, SCD41_DELAI_COMMANDE_MS);
+        break;
+    case LIRE_SERIE:
+    {
+        uint16_t numero[3];
+        if (decoder_mots(lecture, numero, 3))
+        {
+            planifier(DEMARRER, 0);
+        }
+        else
+        {
+            etat = INACTIF;
+            en_defaut = true;
+        }
+        break;
+    }
+    case DEMARRER:
+        // Première mesure disponible ~5 s (30 s en basse consommation) plus tard
+        planifier(ATTENTE, SCD41_PERIODE_VERIFICATION_MS);
+        break;
+    case ATTENTE:
+        planifier(LIRE_PRETE, SCD41_DELAI_COMMANDE_MS);
+        break;
+    case LIRE_PRETE:
+    {
+        uint16_t statut = 0;
+        // Donnée prête si les 11 bits de poids faible ne sont pas tous nuls
+        if (decoder_mots(lecture, &statut, 1) && (statut & 0x07FF) != 0)
+            planifier(ENVOYER_LECTURE, 0);
+        else
+            planifier(ATTENTE, SCD41_PERIODE_VERIFICATION_MS);
+        break;
+    }
+    case ENVOYER_LECTURE:
+        planifier(LIRE_MESURE, SCD41_DELAI_COMMANDE_MS);
+        break;
+    case LIRE_MESURE:
+    {
+        uint16_t mots[3];
+        if (decoder_mots(lecture, mots, 3))
+        {
+            mesure.co2_ppm = mots[0];
+            mesure.temperature_c = -45.0f + 175.0f * mots[1] / 65536.0f;
+            mesure.humidite_pct = 100.0f * mots[2] / 65536.0f;
+            mesure.horodatage_ms = millis();
+            nouvelle_mesure = true;
+        }
+        planifier(ATTENTE, SCD41_PERIODE_VERIFICATION_MS);
+        break;
+    }
+    default:
+        planifier(ATTENTE, SCD41_PERIODE_VERIFICATION_MS);
+        break;
+    }
+}
+
+void scd41_demarrer(bool basse_consommation)
+{
+    basse_consommation_demandee = basse_consommation;
+    en_defaut = false;
+    generation++;
+    planifier(ARRETER, 0);
+}
+
+bool scd41_en_defaut()
+{
+    return en_defaut;
+}
+
+/*
+ * Fonction : commande_etape
+ * But : Commande envoyée par une étape (0 : l'étape lit une réponse)
+ */
+static uint16_t commande_etape(EtatScd41 etape)
+{
+    switch (etape)
+    {
+    case ARRETER:
+        return SCD41_CMD_ARRETER;
+    case REINITIALISER:
+        return SCD41_CMD_REINITIALISER;
+    case NUMERO_SERIE:
+        return SCD41_CMD_NUMERO_SERIE;
+    case DEMARRER:
+        return basse_consommation_demandee ? SCD41_CMD_DEMARRER_BASSE_CONSOMMATION : SCD41_CMD_DEMARRER;
+    case ATTENTE:
+        return SCD41_CMD_DONNEE_PRETE;
+    case ENVOYER_LECTURE:
+        return SCD41_CMD_LIRE_MESURE;
+    default:
+        return 0;
+    }
+}
+
+bool scd41_executer(uint32_t maintenant)
+{
+    // Comparaison signée pour rester valide au débordement de millis()
+    if (etat != INACTIF && etat != EN_COURS && static_cast<int32_t>(maintenant - echeance) >= 0)
+    {
+        TransactionI2C transaction = {};
+        transaction.adresse = SCD41_ADRESSE;
+        transaction.fin = fin_etape;
+        transaction.point = POINT_I2C_SCD41;
+        transaction.contexte = etat | (static_cast<uint32_t>(generation) << 8);
+
+        uint16_t commande = commande_etape(etat);
+        if (commande != 0)
+        {
+            transaction.ecriture[0] = static_cast<uint8_t>(commande >> 8);
+            transaction.ecriture[1] = static_cast<uint8_t>(commande & 0xFF);
+            transaction.nb_ecriture = 2;
+        }
+        else
+        {
+            // Réponses : état « donnée prête » (1 mot), numéro de série ou mesure (3 mots)
+            transaction.nb_lecture = etat == LIRE_PRETE ? 3 : 9;
+        }
+
+        // Si la file est pleine, l'étape sera soumise au prochain appel
+        if (bus_i2c_soumettre(transaction))
+            etat = EN_COURS;
+    }
+
+    bool nouvelle = nouvelle_mesure;
+    nouvelle_mesure = false;
+    return nouvelle;
+}
+
+const Scd41Mesure &scd41_mesure()
+{
+    return mesure;
+}
@@ -0,0 +1,35 @@
+#include "sommeil.h"
+
+#include <Arduino.h>
+#include "can_rx.h"
+#include "instrumentation.h"
+
+void sommeil_attendre()
+{
+    // Le compteur de cycles n'avance pas forcément en mode Sleep : durée
+    // mesurée avec micros(), lu interruptions démasquées (SysTick à jour),
+    // donc avant le masquage et après le réveil
+    uint32_t debut_us = micros();
+
+    // WFI réveille le cœur même interruptions masquées : l'interruption en
+    // attente n'est servie qu'au démasquage, après la mesure
+    __disable_irq();
+    if (can_rx_en_attente())
+    {
+        __enable_irq();
+        return;
+    }
+
+    uint32_t interruption = can_rx_cycles_interruption();
+    __DSB();
+    __WFI();
+    __enable_irq();
+    uint32_t duree_us = micros() - debut_us;
+
+    instrumentation_ajouter(POINT_SOMMEIL, duree_us * (F_CPU / 1000000UL));
+
+    // Réveil par une trame CAN : le gestionnaire vient de s'exécuter
+    uint32_t fin = cycles_lire();
+    if (can_rx_cycles_interruption() != interruption)
+        instrumentation_ajouter(POINT_REVEIL, fin - can_rx_cycles_interruption());
+}
@@ -0,0 +1,103 @@
+#include "statistiques.h"
+
+#include "bus_i2c.h"
+#include "can_rx.h"
+#include "can_tx.h"
+#include "capteurs.h"
+#include "instrumentation.h"
+
+#define MAX_24_BITS 0xFFFFFFUL
+
+static uint32_t requetes = 0;
+static uint32_t requetes_en_retard = 0;
+static uint32_t trames_ignorees = 0;
+
+// Passages dans loop() : seconde en cours et dernière seconde complète
+static uint32_t boucles = 0;
+static uint32_t boucles_par_seconde = 0;
+static uint32_t debut_seconde = 0;
+
+void statistiques_requete(uint16_t reception_ms, uint32_t maintenant)
+{
+    requetes++;
+    if (static_cast<uint16_t>(maintenant - reception_ms) > STATISTIQUES_RETARD_MS)
+        requetes_en_retard++;
+}
+
+void statistiques_requete_groupe()
+{
+    requetes++;
+}
+
+void statistiques_ignoree()
+{
+    trames_ignorees++;
+}
+
+void statistiques_boucle(uint32_t maintenant)
+{
+    boucles++;
+    if (maintenant - debut_seconde >= 1000)
+    {
+        boucles_par_seconde = boucles;
+        boucles = 0;
+        debut_seconde = maintenant;
+    }
+}
+
+// Compteur cumulé : envoyé modulo 2^24 plutôt que saturé
+static uint32_t modulo(uint32_t valeur)
+{
+    return valeur & MAX_24_BITS;
+}
+
+void statistiques_trame(uint8_t numero, uint32_t maintenant, uint8_t donnees[8])
+{
+    uint32_t premier = 0;
+    uint32_t second = 0;
+
+    switch (numero)
+    {
+    case 0:
+        premier = modulo(can_rx_recues());
+        second = modulo(trames_ignorees);
+        break;
+    case 1:
+        premier = modulo(requetes);
+        second = modulo(requetes_en_retard);
+        break;
+    case 2:
+        premier = modulo(can_tx_envoyees());
+        second = modulo(can_tx_echouees());
+        break;
+    case 3:
+        premier = modulo(can_tx_debordements());
+        second = modulo(can_tx_boites_pleines());
+        break;
+    case 4:
+        premier = modulo(can_rx_debordements_anneau());
+        second = modulo(can_rx_debordements_fifo());
+        break;
+    case 5:
+        premier = modulo(bus_i2c_erreurs());
+        second = modulo(bus_i2c_recuperations());
+        break;
+    case 6:
+        // Âges saturés par instrumentation_trame_compteurs()
+        premier = capteurs_age_ms(CAPTEUR_ADS7828, maintenant);
+        second = capteurs_age_ms(CAPTEUR_BME280, maintenant);
+        break;
+    case 7:
+        premier = capteurs_age_ms(CAPTEUR_SCD41, maintenant);
+        second = boucles_par_seconde;
+        break;
+    case 8:
+        premier = modulo(bus_i2c_nacks());
+        second = modulo(bus_i2c_transactions());
+        break;
+    default:
+        break;
+    }
+
+    instrumentation_trame_compteurs(DIAG_ETIQUETTE_STATISTIQUES + numero, premier, second, donnees);
+}
@@ -0,0 +1,235 @@
+#include "stockage.h"
+
+#include <Arduino.h>
+
+// Un enregistrement : en-tête, contenu complété au mot de 32 bits, CRC-32
+#define STOCKAGE_MAGIQUE 0xCA5Eu
+#define MOT_EFFACE 0xFFFFFFFFu
+
+// Premier mot d'un secteur : marque et génération (16 bits de poids fort),
+// incrémentée à chaque changement de secteur
+#define STOCKAGE_MAGIQUE_SECTEUR 0x5EC7u
+
+static uint32_t crc32(const uint8_t *donnees, uint32_t longueur, uint32_t crc = 0xFFFFFFFFu)
+{
+    for (uint32_t i = 0; i < longueur; i++)
+    {
+        crc ^= donnees[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return crc;
+}
+
+static inline uint32_t lire_mot(uint32_t adresse)
+{
+    return *reinterpret_cast<const volatile uint32_t *>(static_cast<uintptr_t>(adresse));
+}
+
+static inline uint32_t taille_enregistrement(uint16_t taille)
+{
+    return 4 + ((taille + 3u) & ~3u) + 4;
+}
+
+static inline uint32_t debut_secteur(int secteur)
+{
+    return STOCKAGE_ADRESSE + static_cast<uint32_t>(secteur) * STOCKAGE_TAILLE;
+}
+
+static inline uint32_t fin_secteur(int secteur)
+{
+    return debut_secteur(secteur) + STOCKAGE_TAILLE;
+}
+
+/*
+ * Fonction : enregistrement_valide
+ * But : Vérifie l'en-tête et le CRC de l'enregistrement situé à une adresse
+ * Paramètres :
+ *    - adresse : début de l'enregistrement
+ *    - fin : fin du secteur qui le contient
+ * Retour :
+ *    - taille du contenu, ou -1 si l'enregistrement est invalide
+ */
+static int32_t enregistrement_valide(uint32_t adresse, uint32_t fin)
+{
+    uint32_t entete = lire_mot(adresse);
+    if ((entete & 0xFFFF) != STOCKAGE_MAGIQUE)
+        return -1;
+
+    uint16_t taille = static_cast<uint16_t>(entete >> 16);
+    if (taille > STOCKAGE_TAILLE_MAX || adresse + taille_enregistrement(taille) > fin)
+        return -1;
+
+    uint32_t longueur = taille_enregistrement(taille) - 4;
+    const uint8_t *octets = reinterpret_cast<const uint8_t *>(static_cast<uintptr_t>(adresse));
+    if ((crc32(octets, longueur) ^ 0xFFFFFFFFu) != lire_mot(adresse + longueur))
+        return -1;
+
+    return taille;
+}
+
+/*
+ * Structure : Journal
+ * But : État d'un secteur relu par parcourir()
+ */
+struct Journal
+{
+    uint32_t dernier;    // dernier enregistrement valide (0 : aucun)
+    uint32_t libre;      // première adresse libre (fin du secteur s'il est plein)
+    uint16_t generation; // 0 pour un secteur sans marque (versions à un seul secteur)
+};
+
+/*
+ * Fonction : parcourir
+ * But : Trouve le dernier enregistrement valide et la première adresse libre d'un secteur
+ */
+static Journal parcourir(int secteur)
+{
+    Journal journal = {0, debut_secteur(secteur), 0};
+    uint32_t fin = fin_secteur(secteur);
+
+    uint32_t marque = lire_mot(journal.libre);
+    if ((marque & 0xFFFF) == STOCKAGE_MAGIQUE_SECTEUR)
+    {
+        journal.generation = static_cast<uint16_t>(marque >> 16);
+        journal.libre += 4;
+    }
+
+    while (journal.libre < fin && lire_mot(journal.libre) != MOT_EFFACE)
+    {
+        int32_t taille = enregistrement_valide(journal.libre, fin);
+        if (taille < 0)
+        {
+            // Écriture interrompue : le reste du secteur est inutilisable
+            journal.libre = fin;
+            break;
+        }
+        journal.dernier = journal.libre;
+        journal.libre += taille_enregistrement(static_cast<uint16_t>(taille));
+    }
+    return journal;
+}
+
+/*
+ * Fonction : secteur_courant
+ * But : Secteur de génération la plus récente qui contient un enregistrement valide
+ * Retour :
+ *    - numéro du secteur, ou -1 si aucun ne contient d'enregistrement
+ */
+static int secteur_courant(Journal &journal)
+{
+    int courant = -1;
+    for (int secteur = 0; secteur < STOCKAGE_NB_SECTEURS; secteur++)
+    {
+        Journal candidat = parcourir(secteur);
+        if (candidat.dernier == 0)
+            continue;
+        if (courant < 0 || static_cast<int16_t>(candidat.generation - journal.generation) > 0)
+        {
+            courant = secteur;
+            journal = candidat;
+        }
+    }
+    return courant;
+}
+
+static bool secteur_vierge(int secteur)
+{
+    for (uint32_t adresse = debut_secteur(secteur); adresse < fin_secteur(secteur); adresse += 4)
+    {
+        if (lire_mot(adresse) != MOT_EFFACE)
+            return false;
+    }
+    return true;
+}
+
+static bool effacer_secteur(int secteur)
+{
+    FLASH_EraseInitTypeDef effacement = {};
+    effacement.TypeErase = FLASH_TYPEERASE_SECTORS;
+    effacement.Sector = FLASH_SECTOR_6 + static_cast<uint32_t>(secteur);
+    effacement.NbSectors = 1;
+    effacement.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    uint32_t erreur = 0;
+    return HAL_FLASHEx_Erase(&effacement, &erreur) == HAL_OK;
+}
+
+/*
+ * Fonction : programmer
+ * But : Écrit des mots à partir d'une adresse, puis les relit
+ * Retour :
+ *    - false si une écriture a échoué ou si la flash ne contient pas les mots
+ */
+static bool programmer(uint32_t adresse, const uint32_t *mots, uint32_t nb_mots)
+{
+    for (uint32_t i = 0; i < nb_mots; i++)
+    {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, adresse + 4 * i, mots[i]) != HAL_OK)
+            return false;
+    }
+    return memcmp(reinterpret_cast<const void *>(static_cast<uintptr_t>(adresse)), mots, 4 * nb_mots) == 0;
+}
+
+bool stockage_lire(void *donnees, uint16_t taille)
+{
+    Journal journal;
+    int courant = secteur_courant(journal);
+    if (courant < 0 || enregistrement_valide(journal.dernier, fin_secteur(courant)) != taille)
+        return false;
+
+    memcpy(donnees, reinterpret_cast<const void *>(static_cast<uintptr_t>(journal.dernier + 4)), taille);
+    return true;
+}
+
+bool stockage_ecrire(const void *donnees, uint16_t taille)
+{
+    if (taille > STOCKAGE_TAILLE_MAX)
+        return false;
+
+    // Enregistrement complet préparé en RAM : en-tête, contenu, CRC
+    uint32_t mots[(4 + STOCKAGE_TAILLE_MAX + 4) / 4] = {};
+    uint32_t longueur = taille_enregistrement(taille);
+    mots[0] = STOCKAGE_MAGIQUE | (static_cast<uint32_t>(taille) << 16);
+    for (uint32_t i = 0; i < (taille + 3u) / 4u; i++)
+    {
+        mots[1 + i] = MOT_EFFACE;
+    }
+    memcpy(&mots[1], donnees, taille);
+    mots[longueur / 4 - 1] = crc32(reinterpret_cast<const uint8_t *>(mots), longueur - 4) ^ 0xFFFFFFFFu;
+
+    Journal journal = {0, 0, 0};
+    int courant = secteur_courant(journal);
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR |
+                           FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+
+    bool reussi;
+    if (courant >= 0 && journal.libre + longueur <= fin_secteur(courant))
+    {
+        // Ajout à la suite : une coupure ne touche que le nouvel enregistrement
+        reussi = programmer(journal.libre, mots, longueur / 4);
+    }
+    else
+    {
+        // Secteur plein : l'enregistrement ouvre l'autre secteur, et l'ancien
+        // n'est effacé qu'une fois le nouveau relu. Au plus un effacement par
+        // écriture (voir sante.h) : si l'autre secteur doit d'abord être
+        // effacé, l'ancien le sera au prochain changement de secteur
+        int cible = courant < 0 ? 0 : (courant + 1) % STOCKAGE_NB_SECTEURS;
+        bool efface = !secteur_vierge(cible);
+        reussi = !efface || effacer_secteur(cible);
+
+        uint32_t marque = STOCKAGE_MAGIQUE_SECTEUR | (static_cast<uint32_t>(static_cast<uint16_t>(journal.generation + 1)) << 16);
+        reussi = reussi && programmer(debut_secteur(cible), &marque, 1) &&
+                 programmer(debut_secteur(cible) + 4, mots, longueur / 4);
+
+        if (reussi && courant >= 0 && !efface)
+            effacer_secteur(courant);
+    }
+
+    HAL_FLASH_Lock();
+    return reussi;
+}
@@ -0,0 +1,31 @@
+#include "vecteurs.h"
+
+// 16 exceptions du Cortex-M4 suivies des interruptions du STM32F446
+#define NB_VECTEURS (16 + FMPI2C1_ER_IRQn + 1)
+
+// VTOR exige un alignement sur la puissance de 2 supérieure à la taille de la table
+alignas(512) static uint32_t vecteurs_ram[NB_VECTEURS];
+static bool vecteurs_en_ram = false;
+
+void vecteurs_remplacer(IRQn_Type irq, void (*gestionnaire)(void))
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!vecteurs_en_ram)
+    {
+        const uint32_t *vecteurs = reinterpret_cast<const uint32_t *>(static_cast<uintptr_t>(SCB->VTOR));
+        for (size_t i = 0; i < NB_VECTEURS; i++)
+        {
+            vecteurs_ram[i] = vecteurs[i];
+        }
+        SCB->VTOR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(vecteurs_ram));
+        vecteurs_en_ram = true;
+    }
+
+    vecteurs_ram[16 + irq] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(gestionnaire));
+    __DSB();
+    __ISB();
+
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,21 @@
+/*
+Double de la librairie STM32_CAN pour l'environnement native
+
+Seul le type CAN_message_t est repris (champs utilisés par les modules
+testés) ; aucun périphérique n'est simulé.
+*/
+
+#ifndef STM32_CAN_H
+#define STM32_CAN_H
+
+#include <stdint.h>
+
+typedef struct CAN_message_t
+{
+    uint32_t id = 0;
+    uint16_t timestamp = 0;
+    uint8_t len = 8;
+    uint8_t buf[8] = {0};
+} CAN_message_t;
+
+#endif
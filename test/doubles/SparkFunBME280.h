@@ -0,0 +1,14 @@
+/*
+Double de la librairie SparkFun BME280 pour l'environnement native
+
+Le type BME280 n'est nécessaire qu'aux déclarations de acquisition.h.
+*/
+
+#ifndef SPARKFUNBME280_H
+#define SPARKFUNBME280_H
+
+class BME280
+{
+};
+
+#endif
@@ -0,0 +1,14 @@
+/*
+Double de la librairie Wire pour l'environnement native
+
+Le type TwoWire n'est nécessaire qu'aux déclarations de acquisition.h.
+*/
+
+#ifndef WIRE_H
+#define WIRE_H
+
+class TwoWire
+{
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+Acquisition, capteurs et adressage factices pour l'environnement native
+
+cache_reponses.cpp est compilé avec les sources testées (test_build_src) :
+chaque suite doit donc fournir les fonctions qu'il appelle. Ce fichier les
+définit et ne doit être inclus que par le test_main.cpp de la suite.
+Les tests règlent directement les valeurs, horodatages et disponibilités.
+*/
+
+#ifndef ACQUISITION_FACTICE_H
+#define ACQUISITION_FACTICE_H
+
+#include "acquisition.h"
+#include "adressage.h"
+#include "capteurs.h"
+
+Mesures mesures_factices = {};
+uint32_t horodatages_factices[NB_DONNEES] = {0};
+bool disponibles_factices[NB_DONNEES] = {false};
+uint32_t rafraichissements_factices[NB_DONNEES] = {0};
+
+const Mesures &acquisition_mesures()
+{
+    return mesures_factices;
+}
+
+uint32_t acquisition_horodatage(Donnee donnee)
+{
+    return horodatages_factices[donnee];
+}
+
+void acquisition_rafraichir(Donnee donnee, uint32_t)
+{
+    rafraichissements_factices[donnee]++;
+}
+
+bool capteurs_donnee_disponible(Donnee donnee)
+{
+    return disponibles_factices[donnee];
+}
+
+uint32_t adressage_base()
+{
+    return CAN_ID_BASE;
+}
+
+#endif
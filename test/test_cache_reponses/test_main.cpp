@@ -0,0 +1,206 @@
+/*
+Tests des modèles de trames de réponse (cache_reponses.h)
+
+Le contenu des trames doit toujours être celui de encoder_donnees() pour
+le même masque ; les fenêtres de fraîcheur ne changent que l'instant où
+une nouvelle valeur est recopiée.
+*/
+
+#include <string.h>
+#include <unity.h>
+
+#include "acquisition_factice.h"
+#include "cache_reponses.h"
+
+static const Mesures mesures_test = {0x1234, 0x0456, 0x0789, 21.9f, 45.7f, 101.3f};
+
+// Instant de chaque test, assez éloigné du précédent pour dépasser toutes les fenêtres
+static uint32_t instant = 0;
+
+void setUp()
+{
+    instant += 100000;
+    mesures_factices = mesures_test;
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        horodatages_factices[i] = instant;
+        disponibles_factices[i] = true;
+        rafraichissements_factices[i] = 0;
+    }
+}
+
+void tearDown()
+{
+}
+
+// Octets des deux trames mis bout à bout (0x1A5 puis 0x1A6)
+static void concatener(CAN_message_t *trames[2], uint8_t donnees[TAILLE_DONNEES])
+{
+    memcpy(donnees, trames[0]->buf, 8);
+    donnees[8] = trames[1]->buf[0];
+}
+
+static void test_identifiants_et_longueurs()
+{
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+    CAN_message_t *trames[2];
+
+    TEST_ASSERT_EQUAL_UINT8(2, cache_reponse(masque, NB_DONNEES, instant, trames));
+    TEST_ASSERT_EQUAL_HEX32(CAN_ID_BASE + CAN_DECALAGE_REPONSE_1, trames[0]->id);
+    TEST_ASSERT_EQUAL_UINT8(8, trames[0]->len);
+    TEST_ASSERT_EQUAL_HEX32(CAN_ID_BASE + CAN_DECALAGE_REPONSE_2, trames[1]->id);
+    TEST_ASSERT_EQUAL_UINT8(1, trames[1]->len);
+}
+
+static void test_identique_a_encoder_donnees()
+{
+    // Tous les masques complets, puis tous les masques raccourcis
+    for (size_t longueur = NB_DONNEES; longueur > 0; longueur--)
+    {
+        for (uint32_t bits = 0; bits < (1u << longueur); bits++)
+        {
+            uint8_t masque[NB_DONNEES];
+            for (size_t i = 0; i < longueur; i++)
+            {
+                masque[i] = (bits & (1u << i)) ? DONNEE_DEMANDEE : 0x00;
+            }
+
+            uint8_t attendu[TAILLE_DONNEES];
+            uint8_t obtenu[TAILLE_DONNEES];
+            CAN_message_t *trames[2];
+            encoder_donnees(mesures_test, masque, longueur, attendu);
+            uint8_t nb_trames = cache_reponse(masque, longueur, instant, trames);
+            concatener(trames, obtenu);
+
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(attendu, obtenu, TAILLE_DONNEES);
+            TEST_ASSERT_EQUAL_UINT8((bits & (1u << DONNEE_PRESSION)) ? 2 : 1, nb_trames);
+        }
+    }
+}
+
+static void test_masque_trop_long()
+{
+    const uint8_t masque[8] = {0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x11, 0x11};
+    uint8_t attendu[TAILLE_DONNEES];
+    uint8_t obtenu[TAILLE_DONNEES];
+    CAN_message_t *trames[2];
+
+    encoder_donnees(mesures_test, masque, NB_DONNEES, attendu);
+    TEST_ASSERT_EQUAL_UINT8(1, cache_reponse(masque, sizeof(masque), instant, trames));
+    concatener(trames, obtenu);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(attendu, obtenu, TAILLE_DONNEES);
+}
+
+static void test_donnee_indisponible()
+{
+    const uint8_t masque[NB_DONNEES] = {0x00, 0x00, 0x11, 0x00, 0x00, 0x00};
+    CAN_message_t *trames[2];
+
+    disponibles_factices[DONNEE_CO] = false;
+    cache_reponse(masque, NB_DONNEES, instant, trames);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, trames[0]->buf[4]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, trames[0]->buf[5]);
+
+    // Le retour du capteur est recopié sans attendre la fenêtre
+    disponibles_factices[DONNEE_CO] = true;
+    cache_reponse(masque, NB_DONNEES, instant + 1, trames);
+    TEST_ASSERT_EQUAL_HEX8(0x89, trames[0]->buf[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x07, trames[0]->buf[5]);
+}
+
+static void test_fenetre_de_fraicheur()
+{
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x00, 0x00, 0x00, 0x00, 0x00};
+    CAN_message_t *trames[2];
+
+    cache_reponse(masque, NB_DONNEES, instant, trames);
+
+    // Nouvelle valeur pendant la fenêtre du méthane (PERIODE_GAZ_MS) : octets conservés
+    mesures_factices.methane_ppm = 0x4321;
+    horodatages_factices[DONNEE_METHANE] = instant + 1;
+    cache_reponse(masque, NB_DONNEES, instant + PERIODE_GAZ_MS / 2, trames);
+    TEST_ASSERT_EQUAL_HEX8(0x34, trames[0]->buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, trames[0]->buf[1]);
+
+    // Fenêtre écoulée : la nouvelle valeur est recopiée
+    cache_reponse(masque, NB_DONNEES, instant + PERIODE_GAZ_MS + 1, trames);
+    TEST_ASSERT_EQUAL_HEX8(0x21, trames[0]->buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x43, trames[0]->buf[1]);
+}
+
+static void test_rafraichissement_des_donnees_anciennes()
+{
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x00, 0x00, 0x11, 0x11, 0x00};
+    CAN_message_t *trames[2];
+
+    // Seule la température, demandée et plus ancienne que sa fenêtre, est relue
+    horodatages_factices[DONNEE_TEMPERATURE] = instant - PERIODE_BME280_MS - 1;
+    horodatages_factices[DONNEE_PRESSION] = instant - PERIODE_BME280_MS - 1;
+    cache_reponse(masque, NB_DONNEES, instant, trames);
+
+    TEST_ASSERT_EQUAL_UINT32(0, rafraichissements_factices[DONNEE_METHANE]);
+    TEST_ASSERT_EQUAL_UINT32(1, rafraichissements_factices[DONNEE_TEMPERATURE]);
+    TEST_ASSERT_EQUAL_UINT32(0, rafraichissements_factices[DONNEE_HUMIDITE]);
+    TEST_ASSERT_EQUAL_UINT32(0, rafraichissements_factices[DONNEE_PRESSION]);
+}
+
+static void test_modifier_fenetre()
+{
+    const uint8_t masque[NB_DONNEES] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x11};
+    CAN_message_t *trames[2];
+
+    TEST_ASSERT_FALSE(cache_modifier_fenetre(NB_DONNEES, 0));
+    TEST_ASSERT_TRUE(cache_modifier_fenetre(DONNEE_PRESSION, 0));
+
+    // Fenêtre nulle : chaque nouvelle valeur est recopiée dès la milliseconde suivante
+    cache_reponse(masque, NB_DONNEES, instant, trames);
+    mesures_factices.pression_kpa = 99.0f;
+    horodatages_factices[DONNEE_PRESSION] = instant + 1;
+    cache_reponse(masque, NB_DONNEES, instant + 1, trames);
+    TEST_ASSERT_EQUAL_UINT8(99, trames[1]->buf[0]);
+
+    TEST_ASSERT_TRUE(cache_modifier_fenetre(DONNEE_PRESSION, table_donnees[DONNEE_PRESSION].periode_ms));
+}
+
+static void test_fenetre_minimale()
+{
+    const uint8_t masque[NB_DONNEES] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x11};
+    CAN_message_t *trames[2];
+
+    TEST_ASSERT_FALSE(cache_modifier_fenetre_minimale(NB_DONNEES, 0));
+    TEST_ASSERT_TRUE(cache_modifier_fenetre(DONNEE_PRESSION, 0));
+    TEST_ASSERT_TRUE(cache_modifier_fenetre_minimale(DONNEE_PRESSION, PERIODE_BME280_MS));
+
+    // Fenêtre configurée plus courte que le minimum : allongée au minimum
+    cache_reponse(masque, NB_DONNEES, instant, trames);
+    mesures_factices.pression_kpa = 98.0f;
+    horodatages_factices[DONNEE_PRESSION] = instant + 1;
+    cache_reponse(masque, NB_DONNEES, instant + 1, trames);
+    TEST_ASSERT_EQUAL_UINT8(101, trames[1]->buf[0]);
+    cache_reponse(masque, NB_DONNEES, instant + PERIODE_BME280_MS + 1, trames);
+    TEST_ASSERT_EQUAL_UINT8(98, trames[1]->buf[0]);
+
+    // Sans minimum, la fenêtre configurée s'applique de nouveau
+    TEST_ASSERT_TRUE(cache_modifier_fenetre_minimale(DONNEE_PRESSION, 0));
+    mesures_factices.pression_kpa = 97.0f;
+    horodatages_factices[DONNEE_PRESSION] = instant + PERIODE_BME280_MS + 2;
+    cache_reponse(masque, NB_DONNEES, instant + PERIODE_BME280_MS + 2, trames);
+    TEST_ASSERT_EQUAL_UINT8(97, trames[1]->buf[0]);
+
+    TEST_ASSERT_TRUE(cache_modifier_fenetre(DONNEE_PRESSION, table_donnees[DONNEE_PRESSION].periode_ms));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_identifiants_et_longueurs);
+    RUN_TEST(test_identique_a_encoder_donnees);
+    RUN_TEST(test_masque_trop_long);
+    RUN_TEST(test_donnee_indisponible);
+    RUN_TEST(test_fenetre_de_fraicheur);
+    RUN_TEST(test_rafraichissement_des_donnees_anciennes);
+    RUN_TEST(test_modifier_fenetre);
+    RUN_TEST(test_fenetre_minimale);
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+/*
+Tests de la conversion des capteurs de gaz (conversion_gaz.h)
+
+computePPM() et les tables sont comparés à la formule de la fiche
+technique calculée en double précision.
+*/
+
+#include <math.h>
+#include <unity.h>
+
+#include "acquisition_factice.h"
+#include "conversion_gaz.h"
+
+/*
+ * Fonction : ppm_reference
+ * But : ppm = 10 ^ ((log10(RS / R0) - b) / m), RS = RL * (Vc - V) / V, saturé à 0..65535,
+ *       V étant la tension du capteur avant le pont diviseur
+ */
+static double ppm_reference(const CalibrationGaz &c, double code)
+{
+    double tension = code * c.vref / (1UL << c.resolution) * c.pont;
+    if (tension <= 0.0)
+        return 0.0;
+
+    double rs = c.rl_kohm * (c.vc - tension) / tension;
+    if (rs <= 0.0)
+        return 65535.0;
+
+    double ppm = pow(10.0, (log10(rs / c.r0_kohm) - c.b) / c.m);
+    return ppm > 65535.0 ? 65535.0 : ppm;
+}
+
+// Écart toléré entre le calcul en float et la référence : 0,1 % ou 1 ppm
+static uint32_t tolerance(double reference)
+{
+    double ecart = reference * 1e-3;
+    return ecart > 1.0 ? static_cast<uint32_t>(ecart + 0.5) : 1;
+}
+
+void setUp()
+{
+    conversion_init(nullptr);
+}
+
+void tearDown()
+{
+}
+
+static void test_compute_ppm_formule()
+{
+    for (int capteur = 0; capteur < NB_GAZ; capteur++)
+    {
+        const CalibrationGaz &calibration = conversion_calibration(static_cast<CapteurGaz>(capteur));
+        for (uint32_t code = 0; code < (1UL << calibration.resolution); code++)
+        {
+            double reference = ppm_reference(calibration, code);
+            TEST_ASSERT_UINT32_WITHIN(tolerance(reference), static_cast<uint32_t>(reference + 0.5),
+                                      computePPM(calibration, static_cast<float>(code)));
+        }
+    }
+}
+
+static void test_compute_ppm_bornes()
+{
+    const CalibrationGaz &calibration = conversion_calibration(GAZ_METHANE);
+
+    // Tension nulle : aucune concentration ; tension au-delà de Vc : saturation
+    TEST_ASSERT_EQUAL_UINT16(0, computePPM(calibration, 0.0f));
+    CalibrationGaz sature = calibration;
+    sature.vc = sature.vref * sature.pont / 2;
+    TEST_ASSERT_EQUAL_UINT16(65535, computePPM(sature, (1UL << sature.resolution) - 1));
+}
+
+static void test_compute_ppm_pont_diviseur()
+{
+    // Pont 10 kΩ / 18 kΩ de l'ADC interne : la tension du capteur est 28/18 fois celle de la broche
+    CalibrationGaz calibration = conversion_calibration(GAZ_METHANE);
+    calibration.vref = 3.3f;
+    calibration.pont = 28.0f / 18.0f;
+
+    for (uint32_t code = 0; code < (1UL << calibration.resolution); code++)
+    {
+        double reference = ppm_reference(calibration, code);
+        TEST_ASSERT_UINT32_WITHIN(tolerance(reference), static_cast<uint32_t>(reference + 0.5),
+                                  computePPM(calibration, static_cast<float>(code)));
+    }
+}
+
+static void test_table_egale_compute_ppm()
+{
+    for (int capteur = 0; capteur < NB_GAZ; capteur++)
+    {
+        CapteurGaz gaz = static_cast<CapteurGaz>(capteur);
+        for (uint32_t code = 0; code < CONVERSION_NB_CODES; code++)
+        {
+            TEST_ASSERT_EQUAL_UINT16(computePPM(conversion_calibration(gaz), static_cast<float>(code)),
+                                     conversion_ppm(gaz, static_cast<uint16_t>(code)));
+        }
+        // Les codes hors table prennent la dernière entrée
+        TEST_ASSERT_EQUAL_UINT16(table_ppm[gaz][CONVERSION_NB_CODES - 1], conversion_ppm(gaz, 0xFFFF));
+    }
+}
+
+static void test_interpolation_formule()
+{
+    const uint8_t bits_fraction = 4;
+    const CalibrationGaz &calibration = conversion_calibration(GAZ_METHANE);
+
+    for (uint32_t code = 0; code < CONVERSION_NB_CODES - 1; code++)
+    {
+        uint16_t bas = conversion_ppm(GAZ_METHANE, static_cast<uint16_t>(code));
+        uint16_t haut = conversion_ppm(GAZ_METHANE, static_cast<uint16_t>(code + 1));
+        TEST_ASSERT_EQUAL_UINT16(bas, conversion_ppm_interpolee(GAZ_METHANE, code << bits_fraction, bits_fraction));
+
+        // Entre deux codes, l'écart à la formule reste inférieur à celui des deux entrées voisines
+        for (uint32_t fraction = 1; fraction < (1u << bits_fraction); fraction++)
+        {
+            uint32_t valeur = (code << bits_fraction) | fraction;
+            double reference = ppm_reference(calibration, static_cast<double>(valeur) / (1u << bits_fraction));
+            uint16_t interpolee = conversion_ppm_interpolee(GAZ_METHANE, valeur, bits_fraction);
+
+            TEST_ASSERT_TRUE(interpolee >= (bas < haut ? bas : haut));
+            TEST_ASSERT_TRUE(interpolee <= (bas < haut ? haut : bas));
+            TEST_ASSERT_UINT32_WITHIN(static_cast<uint32_t>(haut > bas ? haut - bas : bas - haut) + tolerance(reference),
+                                      static_cast<uint32_t>(reference + 0.5), interpolee);
+        }
+    }
+
+    // Au-delà du dernier code : dernière entrée de la table
+    TEST_ASSERT_EQUAL_UINT16(table_ppm[GAZ_METHANE][CONVERSION_NB_CODES - 1],
+                             conversion_ppm_interpolee(GAZ_METHANE, 0xFFFFFFFFUL, bits_fraction));
+}
+
+static void test_modifier_r0_recalcule_table()
+{
+    TEST_ASSERT_FALSE(conversion_modifier_r0(GAZ_CO, 0.0f));
+    TEST_ASSERT_TRUE(conversion_modifier_r0(GAZ_CO, 11.0f));
+
+    const CalibrationGaz &calibration = conversion_calibration(GAZ_CO);
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, calibration.r0_kohm);
+    for (uint32_t code = 0; code < CONVERSION_NB_CODES; code += 97)
+    {
+        TEST_ASSERT_EQUAL_UINT16(computePPM(calibration, static_cast<float>(code)),
+                                 conversion_ppm(GAZ_CO, static_cast<uint16_t>(code)));
+    }
+}
+
+static void test_init_courbes_configurees()
+{
+    // Une pente nulle et un R0 non positif gardent les valeurs par défaut
+    const CourbeGaz courbes[NB_GAZ] = {{-0.5f, 1.0f, 2.0f}, {0.0f, 3.0f, -1.0f}};
+    conversion_init(courbes);
+
+    const CalibrationGaz &methane = conversion_calibration(GAZ_METHANE);
+    TEST_ASSERT_EQUAL_FLOAT(-0.5f, methane.m);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, methane.b);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, methane.r0_kohm);
+
+    const CalibrationGaz &co = conversion_calibration(GAZ_CO);
+    const CalibrationGaz &defaut = conversion_calibration_defaut(GAZ_CO);
+    TEST_ASSERT_EQUAL_FLOAT(defaut.m, co.m);
+    TEST_ASSERT_EQUAL_FLOAT(defaut.b, co.b);
+    TEST_ASSERT_EQUAL_FLOAT(defaut.r0_kohm, co.r0_kohm);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_compute_ppm_formule);
+    RUN_TEST(test_compute_ppm_bornes);
+    RUN_TEST(test_compute_ppm_pont_diviseur);
+    RUN_TEST(test_table_egale_compute_ppm);
+    RUN_TEST(test_interpolation_formule);
+    RUN_TEST(test_modifier_r0_recalcule_table);
+    RUN_TEST(test_init_courbes_configurees);
+    return UNITY_END();
+}
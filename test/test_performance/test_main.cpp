@@ -0,0 +1,118 @@
+/*
+Micro-banc d'essai de l'encodage et de la conversion (environnement native)
+
+Affiche le coût moyen en ns par opération sur la machine hôte. Les
+valeurs servent à comparer deux versions du code entre elles, pas à
+prévoir le coût sur la carte (voir conversion_banc_essai() et
+instrumentation.h pour les mesures en cycles sur la cible).
+*/
+
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+
+#include "acquisition_factice.h"
+#include "cache_reponses.h"
+#include "conversion_gaz.h"
+#include "protocole.h"
+
+// Nombre d'opérations mesurées par fonction
+#define NB_OPERATIONS 1000000UL
+
+static volatile uint32_t puits = 0; // empêche le compilateur d'éliminer les boucles
+
+/*
+ * Fonction : mesurer
+ * But : Exécute NB_OPERATIONS fois une opération et affiche son coût moyen
+ * Paramètres :
+ *    - nom : nom affiché
+ *    - operation : reçoit le rang de l'opération, renvoie une valeur accumulée dans puits
+ */
+template <typename Operation>
+static void mesurer(const char *nom, Operation operation)
+{
+    auto debut = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < NB_OPERATIONS; i++)
+    {
+        puits = puits + operation(i);
+    }
+    auto duree = std::chrono::steady_clock::now() - debut;
+
+    double ns = std::chrono::duration<double, std::nano>(duree).count() / NB_OPERATIONS;
+    char ligne[80];
+    snprintf(ligne, sizeof(ligne), "%-26s %8.1f ns/op", nom, ns);
+    TEST_MESSAGE(ligne);
+}
+
+void setUp()
+{
+    conversion_init(nullptr);
+    mesures_factices = {1004, 803, 52, 21.54f, 45.26f, 101.323f};
+    for (size_t i = 0; i < NB_DONNEES; i++)
+    {
+        disponibles_factices[i] = true;
+    }
+}
+
+void tearDown()
+{
+}
+
+static void test_conversion()
+{
+    const CalibrationGaz &calibration = conversion_calibration(GAZ_METHANE);
+
+    mesurer("computePPM", [&](uint32_t i) { return computePPM(calibration, static_cast<float>(i & 0xFFF)); });
+    mesurer("conversion_ppm", [](uint32_t i) { return conversion_ppm(GAZ_METHANE, i & 0xFFF); });
+    mesurer("conversion_ppm_interpolee", [](uint32_t i) { return conversion_ppm_interpolee(GAZ_METHANE, i & 0xFFFF, 4); });
+}
+
+static void test_encodage()
+{
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+    uint8_t donnees[TAILLE_DONNEES];
+    uint8_t trame[8];
+
+    mesurer("encoder_donnees", [&](uint32_t i) {
+        mesures_factices.methane_ppm = static_cast<uint16_t>(i);
+        encoder_donnees(mesures_factices, masque, NB_DONNEES, donnees);
+        return donnees[0];
+    });
+    mesurer("encoder_compact", [&](uint32_t i) {
+        mesures_factices.methane_ppm = static_cast<uint16_t>(i);
+        encoder_compact(mesures_factices, (1u << NB_DONNEES) - 1, static_cast<uint8_t>(i), trame);
+        return trame[0];
+    });
+}
+
+static void test_cache()
+{
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+    CAN_message_t *trames[2];
+
+    // Aucune nouvelle valeur : les trames du modèle sont rendues telles quelles
+    for (size_t d = 0; d < NB_DONNEES; d++)
+    {
+        horodatages_factices[d] = 0;
+    }
+    mesurer("cache_reponse (inchange)", [&](uint32_t) { return cache_reponse(masque, NB_DONNEES, 0, trames); });
+    // Une nouvelle valeur de chaque donnée à chaque requête, fenêtres écoulées
+    mesurer("cache_reponse (reencode)", [&](uint32_t i) {
+        uint32_t maintenant = i * 10000;
+        for (size_t d = 0; d < NB_DONNEES; d++)
+        {
+            horodatages_factices[d] = maintenant;
+        }
+        mesures_factices.methane_ppm = static_cast<uint16_t>(i);
+        return cache_reponse(masque, NB_DONNEES, maintenant, trames);
+    });
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_conversion);
+    RUN_TEST(test_encodage);
+    RUN_TEST(test_cache);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/*
+Tests de l'encodage des trames (protocole.h, donnees.h)
+
+Ordre des octets des entiers, décodage du masque de requête et
+disposition des champs du format compact.
+*/
+
+#include <unity.h>
+
+#include "acquisition_factice.h"
+#include "protocole.h"
+
+// Toutes les données disponibles, pour encoder_compact()
+#define TOUTES_DISPONIBLES ((1u << NB_DONNEES) - 1)
+
+// Mesures dont chaque octet encodé est différent
+static const Mesures mesures_test = {0x1234, 0x0456, 0x0789, 21.9f, 45.7f, 101.3f};
+
+// Champ de nb_bits bits à partir du bit premier de la trame compacte (lue LSB en premier)
+static uint32_t champ_compact(const uint8_t trame[8], uint8_t premier, uint8_t nb_bits)
+{
+    uint64_t valeur = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        valeur |= static_cast<uint64_t>(trame[i]) << (8 * i);
+    }
+    return static_cast<uint32_t>((valeur >> premier) & ((1ULL << nb_bits) - 1));
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_encoder_uint16_lsb_en_premier()
+{
+    uint8_t memoire[4] = {0};
+    size_t index = 1;
+
+    encoder_uint16(0xA1B2, memoire, index);
+
+    TEST_ASSERT_EQUAL_UINT(3, index);
+    TEST_ASSERT_EQUAL_HEX8(0x00, memoire[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xB2, memoire[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xA1, memoire[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, memoire[3]);
+}
+
+static void test_encoder_float_entier_tronque()
+{
+    uint8_t memoire[1] = {0};
+    size_t index = 0;
+
+    encoder_float_entier(45.99f, memoire, index);
+
+    TEST_ASSERT_EQUAL_UINT(1, index);
+    TEST_ASSERT_EQUAL_UINT8(45, memoire[0]);
+}
+
+static void test_encoder_donnees_masque_complet()
+{
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+    const uint8_t attendu[TAILLE_DONNEES] = {0x34, 0x12, 0x56, 0x04, 0x89, 0x07, 21, 45, 101};
+    uint8_t donnees[TAILLE_DONNEES];
+
+    encoder_donnees(mesures_test, masque, NB_DONNEES, donnees);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(attendu, donnees, TAILLE_DONNEES);
+}
+
+static void test_encoder_donnees_non_demandees_a_ff()
+{
+    // Seul 0x11 demande une donnée : 0x00, 0x10 et 0xFF ne demandent rien
+    const uint8_t masque[NB_DONNEES] = {0x11, 0x00, 0x11, 0x10, 0xFF, 0x11};
+    const uint8_t attendu[TAILLE_DONNEES] = {0x34, 0x12, 0xFF, 0xFF, 0x89, 0x07, 0xFF, 0xFF, 101};
+    uint8_t donnees[TAILLE_DONNEES];
+
+    encoder_donnees(mesures_test, masque, NB_DONNEES, donnees);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(attendu, donnees, TAILLE_DONNEES);
+}
+
+static void test_encoder_donnees_masque_court()
+{
+    // Les octets des données au-delà du masque reçu valent 0
+    const uint8_t masque[2] = {0x00, 0x11};
+    const uint8_t attendu[TAILLE_DONNEES] = {0xFF, 0xFF, 0x56, 0x04, 0, 0, 0, 0, 0};
+    uint8_t donnees[TAILLE_DONNEES];
+
+    encoder_donnees(mesures_test, masque, sizeof(masque), donnees);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(attendu, donnees, TAILLE_DONNEES);
+}
+
+static void test_encoder_donnee_seule()
+{
+    uint8_t donnees[TAILLE_DONNEES] = {0};
+
+    encoder_donnee(mesures_test, DONNEE_CO, donnees);
+    encoder_donnee(mesures_test, NB_DONNEES, donnees); // ignorée
+
+    TEST_ASSERT_EQUAL_HEX8(0x89, donnees[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x07, donnees[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, donnees[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, donnees[6]);
+}
+
+static void test_decoder_masque()
+{
+    const uint8_t masque[8] = {0x11, 0x01, 0x11, 0x00, 0x11, 0x11, 0x11, 0x11};
+
+    TEST_ASSERT_EQUAL_HEX8(0x35, decoder_masque(masque, NB_DONNEES));
+    TEST_ASSERT_EQUAL_HEX8(0x05, decoder_masque(masque, 4));
+    TEST_ASSERT_EQUAL_HEX8(0x00, decoder_masque(masque, 0));
+    // Les octets au-delà de NB_DONNEES sont ignorés
+    TEST_ASSERT_EQUAL_HEX8(0x35, decoder_masque(masque, sizeof(masque)));
+}
+
+static void test_disposition_donnees()
+{
+    // 0x1A5 : méthane, CO2, CO sur deux octets, température et humidité ; 0x1A6 : pression
+    TEST_ASSERT_EQUAL_UINT(9, TAILLE_DONNEES);
+    TEST_ASSERT_EQUAL_UINT(6, position_donnee(DONNEE_TEMPERATURE));
+    TEST_ASSERT_EQUAL_UINT(8, position_donnee(DONNEE_PRESSION));
+    TEST_ASSERT_EQUAL_HEX8(1u << DONNEE_PRESSION, donnees_trame_2());
+}
+
+static void test_encoder_compact_champs()
+{
+    // Valeurs choisies loin d'un demi-pas pour que l'arrondi soit sans ambiguïté
+    const Mesures mesures = {1004, 803, 52, 21.54f, 45.26f, 101.323f};
+    uint8_t trame[8];
+
+    encoder_compact(mesures, TOUTES_DISPONIBLES, 13, trame);
+
+    TEST_ASSERT_EQUAL_UINT32(5, champ_compact(trame, 0, 3));      // séquence sur 3 bits
+    TEST_ASSERT_EQUAL_UINT32(50, champ_compact(trame, 3, 9));     // 1004 ppm / 20
+    TEST_ASSERT_EQUAL_UINT32(80, champ_compact(trame, 12, 10));   // 803 ppm / 10
+    TEST_ASSERT_EQUAL_UINT32(26, champ_compact(trame, 22, 10));   // 52 ppm / 2
+    TEST_ASSERT_EQUAL_UINT32(615, champ_compact(trame, 32, 10));  // (21,54 + 40) / 0,1
+    TEST_ASSERT_EQUAL_UINT32(453, champ_compact(trame, 42, 10));  // 45,26 / 0,1
+    TEST_ASSERT_EQUAL_UINT32(3132, champ_compact(trame, 52, 12)); // (101,323 - 70) / 0,01
+}
+
+static void test_encoder_compact_saturation()
+{
+    const Mesures mesures = {20000, 65535, 0, -55.0f, 150.0f, 120.0f};
+    uint8_t trame[8];
+
+    encoder_compact(mesures, TOUTES_DISPONIBLES, 7, trame);
+
+    // Saturation sous la valeur réservée aux données indisponibles
+    TEST_ASSERT_EQUAL_UINT32(7, champ_compact(trame, 0, 3));
+    TEST_ASSERT_EQUAL_UINT32(510, champ_compact(trame, 3, 9));
+    TEST_ASSERT_EQUAL_UINT32(1022, champ_compact(trame, 12, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, champ_compact(trame, 22, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, champ_compact(trame, 32, 10));
+    TEST_ASSERT_EQUAL_UINT32(1022, champ_compact(trame, 42, 10));
+    TEST_ASSERT_EQUAL_UINT32(4094, champ_compact(trame, 52, 12));
+}
+
+static void test_encoder_compact_indisponible()
+{
+    const Mesures mesures = {1004, 803, 52, 21.54f, 45.26f, 101.323f};
+    uint8_t trame[8];
+
+    // CO2 et pression indisponibles : tous les bits de leur champ à 1
+    encoder_compact(mesures, TOUTES_DISPONIBLES & ~((1u << DONNEE_CO2) | (1u << DONNEE_PRESSION)), 2, trame);
+
+    TEST_ASSERT_EQUAL_UINT32(2, champ_compact(trame, 0, 3));
+    TEST_ASSERT_EQUAL_UINT32(50, champ_compact(trame, 3, 9));
+    TEST_ASSERT_EQUAL_UINT32(1023, champ_compact(trame, 12, 10));
+    TEST_ASSERT_EQUAL_UINT32(26, champ_compact(trame, 22, 10));
+    TEST_ASSERT_EQUAL_UINT32(615, champ_compact(trame, 32, 10));
+    TEST_ASSERT_EQUAL_UINT32(453, champ_compact(trame, 42, 10));
+    TEST_ASSERT_EQUAL_UINT32(4095, champ_compact(trame, 52, 12));
+
+    // Aucune donnée disponible : seule la séquence reste
+    encoder_compact(mesures, 0, 0, trame);
+    const uint8_t attendu[8] = {0xF8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(attendu, trame, 8);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_encoder_uint16_lsb_en_premier);
+    RUN_TEST(test_encoder_float_entier_tronque);
+    RUN_TEST(test_encoder_donnees_masque_complet);
+    RUN_TEST(test_encoder_donnees_non_demandees_a_ff);
+    RUN_TEST(test_encoder_donnees_masque_court);
+    RUN_TEST(test_encoder_donnee_seule);
+    RUN_TEST(test_decoder_masque);
+    RUN_TEST(test_disposition_donnees);
+    RUN_TEST(test_encoder_compact_champs);
+    RUN_TEST(test_encoder_compact_saturation);
+    RUN_TEST(test_encoder_compact_indisponible);
+    return UNITY_END();
+}